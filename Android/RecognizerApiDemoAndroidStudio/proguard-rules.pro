@@ -0,0 +1,10 @@
+# native methods and classes created from native code (src/main/jni/main.cpp) are looked up by name
+-keepclasseswithmembernames class * {
+    native <methods>;
+}
+-keep class com.microblink.api.RecognizerResult {
+    <init>(...);
+}
+-keepclassmembers class com.microblink.api.RecognizerWrapper {
+    long mNativeRecognizer;
+}
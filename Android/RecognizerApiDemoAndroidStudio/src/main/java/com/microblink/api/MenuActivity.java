@@ -7,6 +7,7 @@ import java.io.FileNotFoundException;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.OutputStream;
+import java.nio.ByteBuffer;
 
 import test.photopay.api.R;
 import android.app.Activity;
@@ -38,6 +39,11 @@ public class MenuActivity extends Activity {
     private Button mScanButton;
     private Button mTakePhotoButton;
     private ImageView mImgView;
+    // recognizer is initialized on first scan and reused until activity is destroyed.
+    // Scans and termination both lock mRecognizer, so a scan never runs on a terminated recognizer.
+    private final RecognizerWrapper mRecognizer = new RecognizerWrapper();
+    private volatile boolean mDestroyed = false;
+    private RecognizeTask mRecognizeTask = null;
 
     @Override
     protected void onCreate(Bundle savedInstanceState) {
@@ -88,6 +94,25 @@ public class MenuActivity extends Activity {
         showBitmap();
     }
 
+    @Override
+    protected void onDestroy() {
+        mDestroyed = true;
+        if (mRecognizeTask != null) {
+            mRecognizeTask.cancel(false);
+            mRecognizeTask = null;
+        }
+        // terminate off the UI thread, it waits for a scan that is still running
+        new Thread(new Runnable() {
+            @Override
+            public void run() {
+                synchronized (mRecognizer) {
+                    mRecognizer.terminate();
+                }
+            }
+        }).start();
+        super.onDestroy();
+    }
+
     private void readStream(InputStream is) throws IOException {
         ByteArrayOutputStream baos = new ByteArrayOutputStream();
         copyStream(is, baos, 1024);
@@ -120,7 +145,8 @@ public class MenuActivity extends Activity {
     }
 
     public void scanButtonHandler(View view) {
-        new RecognizeTask().execute();
+        mRecognizeTask = new RecognizeTask();
+        mRecognizeTask.execute();
     }
 
     @Override
@@ -139,9 +165,26 @@ public class MenuActivity extends Activity {
         }
     }
 
+    private static String formatResults(RecognizerResult[] results) {
+        StringBuilder sb = new StringBuilder();
+        for (RecognizerResult result : results) {
+            if (result.isUsdl()) {
+                if (!result.isValid()) {
+                    continue;
+                }
+                sb.append("Type: US Driver's License\n");
+                for (int i = 0; i < result.getFieldCount(); ++i) {
+                    sb.append(result.getFieldKey(i)).append(": ").append(result.getFieldValue(i)).append('\n');
+                }
+                sb.append('\n');
+            } else {
+                sb.append("Type: ").append(result.getType()).append('\n').append(result.getDataAsString()).append("\n\n");
+            }
+        }
+        return sb.toString();
+    }
+
     private class RecognizeTask extends AsyncTask<Void, Void, String> {
-        // recognizer that performs native recognition
-        private RecognizerWrapper mRecognizer = new RecognizerWrapper();
         private ProgressDialog mProgress = null;
 
         @Override
@@ -154,18 +197,31 @@ public class MenuActivity extends Activity {
 
         @Override
         protected String doInBackground(Void... params) {
-            String errorStr = mRecognizer.init();
-            if(errorStr!=null && !"".equals(errorStr)) {
-                mRecognizer.terminate();
-                return errorStr;
+            // native code reads direct buffers in place
+            ByteBuffer image = ByteBuffer.allocateDirect(mImgData.length);
+            image.put(mImgData);
+            synchronized (mRecognizer) {
+                // recognizer may already be terminated by onDestroy, do not create a new one then
+                if (mDestroyed) {
+                    return null;
+                }
+                if (!mRecognizer.isInitialized()) {
+                    String errorStr = mRecognizer.init();
+                    if(errorStr!=null && !"".equals(errorStr)) {
+                        return errorStr;
+                    }
+                }
+                try {
+                    return formatResults(mRecognizer.recognizeEncodedImage(image, mImgData.length));
+                } catch (IllegalStateException e) {
+                    return "Recognizer error " + e.getMessage();
+                }
             }
-            String s = mRecognizer.recognize(mImgData);
-            mRecognizer.terminate();
-            return s;
         }
 
         @Override
         protected void onPostExecute(String result) {
+            mRecognizeTask = null;
             mTakePhotoButton.setEnabled(true);
             mScanButton.setEnabled(true);
             mProgress.dismiss();
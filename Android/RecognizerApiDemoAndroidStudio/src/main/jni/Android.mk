@@ -13,7 +13,6 @@ LOCAL_MODULE := NativeRecognizer
 
 LOCAL_SRC_FILES += 	main.cpp
 
-LOCAL_C_INCLUDES += utf8
 LOCAL_LDLIBS +=  -Wl,--gc-sections -lz -llog -fuse-ld=gold
 
 LOCAL_STATIC_LIBRARIES += RecognizerApi
@@ -4,7 +4,7 @@ include $(CLEAR_VARS)
 RECOGNIZER_API_DIR = ../libRecognizer
 LOCAL_MODULE := RecognizerApi
 LOCAL_SRC_FILES := ../$(RECOGNIZER_API_DIR)/lib/$(TARGET_ARCH_ABI)/lib$(LOCAL_MODULE).a
-LOCAL_EXPORT_C_INCLUDES := $(RECOGNIZER_API_DIR)/inc jni/utf8
+LOCAL_EXPORT_C_INCLUDES := $(RECOGNIZER_API_DIR)/inc
 include $(PREBUILT_STATIC_LIBRARY)
 
 include $(CLEAR_VARS)
@@ -7,14 +7,10 @@
 
 #include <jni.h>
 #include <stdlib.h>
-#include <stdio.h>
+#include <stdint.h>
 #include <android/log.h>
 
 #include "RecognizerApi.h"
-#include "utf8.h"
-#include <string>
-#include <sstream>
-#include <vector>
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,82 +19,187 @@ extern "C" {
 #define LOGD(format, ...) __android_log_print(ANDROID_LOG_DEBUG, "Native recognizer", format, ##__VA_ARGS__);
 #define LOGE(format, ...) __android_log_print(ANDROID_LOG_ERROR, "Native recognizer", format, ##__VA_ARGS__);
 
-static Recognizer* recognizer_ = NULL;
+#define NUM_USDL_FIELDS (sizeof(USDLFieldKeysType) / sizeof(const char*))
+
+/* classes, method and field IDs and constant strings are looked up once in JNI_OnLoad and reused for every frame */
+static jfieldID nativeRecognizerField_ = NULL;
+static jclass resultClass_ = NULL;
+static jmethodID resultConstructor_ = NULL;
+static jclass stringClass_ = NULL;
+static jclass illegalStateExceptionClass_ = NULL;
+static jclass illegalArgumentExceptionClass_ = NULL;
+static jclass outOfMemoryErrorClass_ = NULL;
+/* values of USDLFieldKeys, in USDLFieldKeysType order */
+static jstring usdlFieldKeys_[NUM_USDL_FIELDS];
+/* names of barcode types, indexed by BarcodeType */
+static jstring barcodeTypeNames_[BARCODE_TYPE_NOT_BARCODE + 1];
+static jstring usdlTypeName_ = NULL;
+/* shared by all barcode results, which have no USDL fields */
+static jobjectArray emptyStringArray_ = NULL;
 
-void onDetectionStarted() {
-    printf("Detection has started!\n");
-}
+/*
+ * Creates Java string from zero-terminated UTF-8 string in a single pass. As of Android 4.4,
+ * NewStringUTF crashes on invalid UTF-8, so bytes that are not part of a valid sequence are
+ * widened to jchar literally, i.e. interpreted as Latin-1. Returns NULL with pending exception
+ * if memory cannot be allocated.
+ */
+static jstring newJavaString(JNIEnv* env, const char* str) {
+    const unsigned char* s = (const unsigned char*) str;
+    size_t len = 0;
+    int ascii = 1;
+    while(s[len] != 0) {
+        if(s[len] >= 0x80) ascii = 0;
+        ++len;
+    }
+    if(ascii) {
+        return env->NewStringUTF(str);
+    }
 
-int onDetectedObject(const PPPoint* points, const size_t pointsSize, PPSize imageSize, PPDetectionStatus ds) {
-    LOGD("Detection on image of size %dx%d has finished\n", imageSize.width, imageSize.height);
-    LOGD("Total %zu points have been found\n", pointsSize);
-    if(pointsSize>0 && points!=NULL) {
-        for(size_t i=0; i<pointsSize; ++i) {
-            LOGD("Point %zu location: (%d, %d)\n", i, points[i].x, points[i].y);
+    /* UTF-16 never needs more code units than UTF-8 needs bytes */
+    jchar stackChars[256];
+    jchar* chars = len <= sizeof(stackChars) / sizeof(jchar) ? stackChars : (jchar*) malloc(len * sizeof(jchar));
+    if(chars == NULL) {
+        env->ThrowNew(outOfMemoryErrorClass_, "cannot allocate string");
+        return NULL;
+    }
+    size_t n = 0;
+    size_t i = 0;
+    while(i < len) {
+        unsigned int cp = s[i];
+        size_t seq = 1;
+        if(s[i] >= 0xC2 && s[i] <= 0xDF) { seq = 2; cp = s[i] & 0x1F; }
+        else if(s[i] >= 0xE0 && s[i] <= 0xEF) { seq = 3; cp = s[i] & 0x0F; }
+        else if(s[i] >= 0xF0 && s[i] <= 0xF4) { seq = 4; cp = s[i] & 0x07; }
+        if(seq > 1) {
+            size_t j = 1;
+            for(; j < seq && i + j < len && (s[i + j] & 0xC0) == 0x80; ++j) {
+                cp = (cp << 6) | (s[i + j] & 0x3F);
+            }
+            /* reject truncated sequences, overlong forms, surrogates and code points above U+10FFFF */
+            if(j < seq || (seq == 3 && cp < 0x800) || (seq == 4 && (cp < 0x10000 || cp > 0x10FFFF)) || (cp >= 0xD800 && cp <= 0xDFFF)) {
+                seq = 1;
+                cp = s[i];
+            }
         }
+        if(cp >= 0x10000) {
+            cp -= 0x10000;
+            chars[n++] = (jchar) (0xD800 + (cp >> 10));
+            chars[n++] = (jchar) (0xDC00 + (cp & 0x3FF));
+        } else {
+            chars[n++] = (jchar) cp;
+        }
+        i += seq;
     }
-    const char* detStatusDesc = "";
-    switch(ds) {
-    case DETECTION_STATUS_CAMERA_AT_ANGLE:
-        detStatusDesc = "camera is at angle";
-        break;
-    case DETECTION_STATUS_CAMERA_TOO_HIGH:
-        detStatusDesc = "camera is too high";
-        break;
-    case DETECTION_STATUS_FAIL:
-        detStatusDesc = "detection has failed";
-        break;
-    case DETECTION_STATUS_PARTIAL_OBJECT:
-        detStatusDesc = "some parts of object are not visible";
-        break;
-    case DETECTION_STATUS_QR_SUCCESS:
-        detStatusDesc = "QR code has been successfuly detected";
-        break;
-    case DETECTION_STATUS_SUCCESS:
-        detStatusDesc = "detection has succeeded";
-        break;
+    jstring jStr = env->NewString(chars, (jsize) n);
+    if(chars != stackChars) {
+        free(chars);
     }
-    LOGD("Detection status: %s\n", detStatusDesc);
-    return 1;
+    return jStr;
 }
 
-void onDetectionFailed() {
-    LOGD("Detection has completely failed\n");
+static jstring newGlobalString(JNIEnv* env, const char* str) {
+    jstring local = newJavaString(env, str);
+    if(local == NULL) {
+        return NULL;
+    }
+    jstring global = (jstring) env->NewGlobalRef(local);
+    env->DeleteLocalRef(local);
+    return global;
 }
 
-void onRecognitionStarted() {
-    LOGD("Object recognition has started\n");
+static jclass findGlobalClass(JNIEnv* env, const char* name) {
+    jclass local = env->FindClass(name);
+    if(local == NULL) {
+        return NULL;
+    }
+    jclass global = (jclass) env->NewGlobalRef(local);
+    env->DeleteLocalRef(local);
+    return global;
+}
+
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void*) {
+    JNIEnv* env;
+    if(vm->GetEnv((void**) &env, JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+
+    resultClass_ = findGlobalClass(env, "com/microblink/api/RecognizerResult");
+    stringClass_ = findGlobalClass(env, "java/lang/String");
+    illegalStateExceptionClass_ = findGlobalClass(env, "java/lang/IllegalStateException");
+    illegalArgumentExceptionClass_ = findGlobalClass(env, "java/lang/IllegalArgumentException");
+    outOfMemoryErrorClass_ = findGlobalClass(env, "java/lang/OutOfMemoryError");
+    if(resultClass_ == NULL || stringClass_ == NULL || illegalStateExceptionClass_ == NULL || illegalArgumentExceptionClass_ == NULL
+            || outOfMemoryErrorClass_ == NULL) {
+        LOGE("Cannot find classes used by native recognizer\n");
+        return JNI_ERR;
+    }
+    /* keep in sync with RecognizerResult constructor */
+    resultConstructor_ = env->GetMethodID(resultClass_, "<init>", "(ZLjava/lang/String;ZZ[B[B[Ljava/lang/String;[Ljava/lang/String;)V");
+    if(resultConstructor_ == NULL) {
+        LOGE("Cannot find RecognizerResult constructor\n");
+        return JNI_ERR;
+    }
+    /* each RecognizerWrapper owns its recognizer, stored in a long field */
+    jclass wrapperClass = env->FindClass("com/microblink/api/RecognizerWrapper");
+    nativeRecognizerField_ = wrapperClass != NULL ? env->GetFieldID(wrapperClass, "mNativeRecognizer", "J") : NULL;
+    if(nativeRecognizerField_ == NULL) {
+        LOGE("Cannot find RecognizerWrapper.mNativeRecognizer\n");
+        return JNI_ERR;
+    }
+    env->DeleteLocalRef(wrapperClass);
+
+    const char* const* keys = (const char* const*) &USDLFieldKeys;
+    for(size_t i = 0; i < NUM_USDL_FIELDS; ++i) {
+        usdlFieldKeys_[i] = keys[i] != NULL ? newGlobalString(env, keys[i]) : NULL;
+        if(keys[i] != NULL && usdlFieldKeys_[i] == NULL) {
+            LOGE("Cannot create USDL field key strings\n");
+            return JNI_ERR;
+        }
+    }
+    for(int type = 0; type <= BARCODE_TYPE_NOT_BARCODE; ++type) {
+        barcodeTypeNames_[type] = newGlobalString(env, barcodeTypeToString((BarcodeType) type));
+        if(barcodeTypeNames_[type] == NULL) {
+            LOGE("Cannot create barcode type name strings\n");
+            return JNI_ERR;
+        }
+    }
+    usdlTypeName_ = newGlobalString(env, "USDL");
+    if(usdlTypeName_ == NULL) {
+        return JNI_ERR;
+    }
+
+    jobjectArray emptyArray = env->NewObjectArray(0, stringClass_, NULL);
+    if(emptyArray == NULL) {
+        return JNI_ERR;
+    }
+    emptyStringArray_ = (jobjectArray) env->NewGlobalRef(emptyArray);
+    env->DeleteLocalRef(emptyArray);
+
+    return JNI_VERSION_1_6;
 }
 
-void onRecognitionFinished() {
-    LOGD("Object recognition has finished\n");
+/* Java methods that access the recognizer are synchronized, so these never race with each other */
+static Recognizer* getRecognizer(JNIEnv* env, jobject thiz) {
+    return (Recognizer*) (intptr_t) env->GetLongField(thiz, nativeRecognizerField_);
 }
 
-RecognizerCallback buildRecognizerCallback() {
-    RecognizerCallback cb;
-    /* onDetectedObject is called when recognizer detects an object in image */
-    cb.onDetectedObject = onDetectedObject;
-    /* onDetectionStarted is called when recognizer begins object detection process */
-    cb.onDetectionStarted = onDetectionStarted;
-    /* onDetectionFailed is called when all enabled recognizers do not detect anything on the image */
-    cb.onDetectionFailed = onDetectionFailed;
-    /* onRecognitionStarted is called when recognition of detected object begins */
-    cb.onRecognitionStarted = onRecognitionStarted;
-    /* onRecognitionFinished is called when recognition of detected object finishes */
-    cb.onRecognitionFinished = onRecognitionFinished;
-    /* onProgress is called in some recognizers to provide progress information. Here we are not interested in this callback. */
-    cb.onProgress = NULL;
-    /* onShouldStopRecognition is called multiple times from some recognizers to check if recognition should be canceled. */
-    cb.onShouldStopRecognition = NULL;
-    return cb;
+static void deleteRecognizer(JNIEnv* env, jobject thiz) {
+    Recognizer* recognizer = getRecognizer(env, thiz);
+    if(recognizer != NULL) {
+        env->SetLongField(thiz, nativeRecognizerField_, 0);
+        recognizerDelete(&recognizer);
+    }
 }
 
 /*
  * Class:     com_microblink_api_RecognizerWrapper
  * Method:    init
- * Signature: ()V
+ * Signature: ()Ljava/lang/String;
  */
-JNIEXPORT jstring JNICALL Java_com_microblink_api_RecognizerWrapper_init(JNIEnv* env, jobject) {
+JNIEXPORT jstring JNICALL Java_com_microblink_api_RecognizerWrapper_init(JNIEnv* env, jobject thiz) {
+
+    /* recognizer is created once and reused, calling init again replaces it */
+    deleteRecognizer(env, thiz);
 
 	/* create recognizer settings object. Do not forget to delete it after usage. */
     RecognizerSettings* settings;
@@ -135,7 +236,7 @@ JNIEXPORT jstring JNICALL Java_com_microblink_api_RecognizerWrapper_init(JNIEnv*
 
     /* insert license key and licensee */
     recognizerSettingsSetLicenseKey(settings, "add licensee here", "add license key here");
-    Recognizer* recognizer;
+    Recognizer* recognizer = NULL;
     /* create global recognizer with settings */
     RecognizerErrorStatus status = recognizerCreate(&recognizer, settings);
 
@@ -144,11 +245,12 @@ JNIEXPORT jstring JNICALL Java_com_microblink_api_RecognizerWrapper_init(JNIEnv*
     if(status!=RECOGNIZER_ERROR_STATUS_SUCCESS) {
         errorStr = recognizerErrorToString(status);
         LOGE("%s", errorStr);
+        recognizer = NULL;
     }
 
     recognizerSettingsDelete(&settings);
 
-    recognizer_ = recognizer;
+    env->SetLongField(thiz, nativeRecognizerField_, (jlong) (intptr_t) recognizer);
 
     return env->NewStringUTF(errorStr);
 }
@@ -158,120 +260,245 @@ JNIEXPORT jstring JNICALL Java_com_microblink_api_RecognizerWrapper_init(JNIEnv*
  * Method:    terminate
  * Signature: ()V
  */
-JNIEXPORT void JNICALL Java_com_microblink_api_RecognizerWrapper_terminate(JNIEnv*, jobject) {
-    if(recognizer_ != NULL) {
-        recognizerDelete(&recognizer_);
-    }
+JNIEXPORT void JNICALL Java_com_microblink_api_RecognizerWrapper_terminate(JNIEnv* env, jobject thiz) {
+    deleteRecognizer(env, thiz);
 }
 
 /*
  * Class:     com_microblink_api_RecognizerWrapper
- * Method:    recognize
- * Signature: ([BII)Ljava/lang/String;
+ * Method:    reset
+ * Signature: ()V
  */
-JNIEXPORT jstring JNICALL Java_com_microblink_api_RecognizerWrapper_recognize(JNIEnv* env, jobject thiz, jbyteArray bytes) {
-
-    jbyte* buffer = env->GetByteArrayElements(bytes, 0);
-    jsize bufferLen = env->GetArrayLength(bytes);
-
-    RecognizerErrorStatus status;
-    /* build recognizer callback structure */
-    RecognizerCallback cb = buildRecognizerCallback();
-
-    // define scanning region
-//    PPRectangle roi;
-//    roi.x = 0.f; roi.y=0.f; roi.width=0.5f; roi.height=1.f;
-//    recognizerSetROI(recognizer_, &roi);
-
-    RecognizerResultList* resultList;
-    status = recognizerRecognizeFromEncodedImage(recognizer_, &resultList, buffer, bufferLen, &cb);
-    env->ReleaseByteArrayElements(bytes, buffer, 0);
-
-    if (status != RECOGNIZER_ERROR_STATUS_SUCCESS) {
-        char err[1000];
-        sprintf(err, "Recognizer error %s", recognizerErrorToString(status));
-        return env->NewStringUTF(err);
+JNIEXPORT void JNICALL Java_com_microblink_api_RecognizerWrapper_reset(JNIEnv* env, jobject thiz) {
+    Recognizer* recognizer = getRecognizer(env, thiz);
+    if(recognizer != NULL) {
+        recognizerReset(recognizer);
     }
+}
 
-    std::stringstream ss;
+static jbyteArray newByteArray(JNIEnv* env, const void* data, size_t size) {
+    jbyteArray array = env->NewByteArray((jsize) size);
+    if(array != NULL && size > 0) {
+        env->SetByteArrayRegion(array, 0, (jsize) size, (const jbyte*) data);
+    }
+    return array;
+}
 
-    size_t numResults;
-    recognizerResultListGetNumOfResults(resultList, &numResults);
+/* creates Java RecognizerResult, returns NULL with pending exception if Java allocation fails */
+static jobject newResultObject(JNIEnv* env, RecognizerResult* result) {
+    int isUsdl = 0;
+    int valid = 0;
+    int uncertain = 0;
+    const void* raw = NULL;
+    size_t rawSize = 0;
+    const void* extended = NULL;
+    size_t extendedSize = 0;
+    jstring type = NULL;
+    jbyteArray extendedArray = NULL;
+    jobjectArray fieldKeys = emptyStringArray_;
+    jobjectArray fieldValues = emptyStringArray_;
+
+    recognizerResultIsResultValid(result, &valid);
+    recognizerResultIsResultUncertain(result, &uncertain);
+
+    if(recognizerResultIsUSDLResult(result, &isUsdl) == RECOGNIZER_ERROR_STATUS_SUCCESS && isUsdl) {
+        type = usdlTypeName_;
+        if(recognizerResultGetUSDLRawBinaryData(result, &raw, &rawSize) != RECOGNIZER_ERROR_STATUS_SUCCESS || raw == NULL) {
+            rawSize = 0;
+        }
 
-    for(size_t i = 0; i< numResults; ++i) {
-		RecognizerResult* result;
-		int isUsdl = 0;
+        /* every field is queried once, empty fields are left out */
+        const char* values[NUM_USDL_FIELDS];
+        jsize numFields = 0;
+        for(size_t i = 0; i < NUM_USDL_FIELDS; ++i) {
+            values[i] = NULL;
+            if(usdlFieldKeys_[i] != NULL && recognizerResultGetUSDLField(result, &values[i], ((const char* const*) &USDLFieldKeys)[i]) == RECOGNIZER_ERROR_STATUS_SUCCESS
+                    && values[i] != NULL && values[i][0] != '\0') {
+                ++numFields;
+            } else {
+                values[i] = NULL;
+            }
+        }
 
-		/* obtain i-th result from list */
-		recognizerResultListGetResultAtIndex(resultList, i, &result);
+        fieldKeys = env->NewObjectArray(numFields, stringClass_, NULL);
+        fieldValues = fieldKeys != NULL ? env->NewObjectArray(numFields, stringClass_, NULL) : NULL;
+        if(fieldValues == NULL) {
+            return NULL;
+        }
+        jsize j = 0;
+        for(size_t i = 0; i < NUM_USDL_FIELDS; ++i) {
+            if(values[i] == NULL) continue;
+            jstring value = newJavaString(env, values[i]);
+            if(value == NULL) {
+                return NULL;
+            }
+            env->SetObjectArrayElement(fieldKeys, j, usdlFieldKeys_[i]);
+            env->SetObjectArrayElement(fieldValues, j, value);
+            env->DeleteLocalRef(value);
+            ++j;
+        }
+    } else {
+        BarcodeType barcodeType;
+        if(recognizerResultGetBarcodeType(result, &barcodeType) == RECOGNIZER_ERROR_STATUS_SUCCESS && barcodeType >= 0 && barcodeType <= BARCODE_TYPE_NOT_BARCODE) {
+            type = barcodeTypeNames_[barcodeType];
+        }
+        if(recognizerResultGetBarcodeRawData(result, &raw, &rawSize) != RECOGNIZER_ERROR_STATUS_SUCCESS || raw == NULL) {
+            rawSize = 0;
+        }
+        if(recognizerResultGetBarcodeExtendedRawData(result, &extended, &extendedSize) == RECOGNIZER_ERROR_STATUS_SUCCESS && extended != NULL) {
+            extendedArray = newByteArray(env, extended, extendedSize);
+            if(extendedArray == NULL) {
+                return NULL;
+            }
+        }
+    }
 
-		/* check if result is obtained from US Driver's License recognizer */
-		status = recognizerResultIsUSDLResult(result, &isUsdl);
-		if(status == RECOGNIZER_ERROR_STATUS_SUCCESS && isUsdl) {
-			int valid = 0;
+    jbyteArray rawArray = newByteArray(env, raw, rawSize);
+    if(rawArray == NULL) {
+        return NULL;
+    }
 
-			/* first determine if USDL result is valid */
-			recognizerResultIsResultValid(result, &valid);
-			if(valid) {
-				const char* firstName;
-				const char* lastName;
-				/* obtain first and last name of the driver */
-				recognizerResultGetUSDLField(result, &firstName, USDLFieldKeys.kCustomerFirstName);
-				recognizerResultGetUSDLField(result, &lastName, USDLFieldKeys.kCustomerFamilyName);
+    jobject obj = env->NewObject(resultClass_, resultConstructor_, (jboolean) (isUsdl != 0), type, (jboolean) (valid != 0),
+            (jboolean) (uncertain != 0), rawArray, extendedArray, fieldKeys, fieldValues);
 
-				LOGD("Driver's license belongs to %s %s\n", firstName, lastName);
-				ss << "Type: US Driver's License" << std::endl << "First name: " << firstName << ", last name: " << lastName << std::endl << std::endl;
-			} else {
-				LOGD("Invalid driver license result!\n");
-			}
+    env->DeleteLocalRef(rawArray);
+    if(extendedArray != NULL) env->DeleteLocalRef(extendedArray);
+    if(fieldKeys != emptyStringArray_) env->DeleteLocalRef(fieldKeys);
+    if(fieldValues != emptyStringArray_) env->DeleteLocalRef(fieldValues);
+    return obj;
+}
 
-		} else {
-			const char* str;
-			BarcodeType barcodeType;
+/* converts results to Java array and deletes the result list. Throws IllegalStateException if recognition failed. */
+static jobjectArray finishRecognition(JNIEnv* env, RecognizerErrorStatus status, RecognizerResultList* resultList) {
+    if(status != RECOGNIZER_ERROR_STATUS_SUCCESS) {
+        if(resultList != NULL) {
+            recognizerResultListDelete(&resultList);
+        }
+        env->ThrowNew(illegalStateExceptionClass_, recognizerErrorToString(status));
+        return NULL;
+    }
 
-			/* obtain the type of the barcode */
-			status = recognizerResultGetBarcodeType(result, &barcodeType);
+    size_t numResults = 0;
+    /* for video frames library may return no list for frames it skips */
+    if(resultList != NULL) {
+        recognizerResultListGetNumOfResults(resultList, &numResults);
+    }
 
-			if (status != RECOGNIZER_ERROR_STATUS_SUCCESS) {
-				char err[1000];
-				sprintf(err, "Error obtaining barcode type: %s", recognizerErrorToString(status));
-				return env->NewStringUTF(err);
-			}
+    jobjectArray results = env->NewObjectArray((jsize) numResults, resultClass_, NULL);
+    for(size_t i = 0; results != NULL && i < numResults; ++i) {
+        RecognizerResult* result;
+        jobject obj = NULL;
+        status = recognizerResultListGetResultAtIndex(resultList, i, &result);
+        if(status != RECOGNIZER_ERROR_STATUS_SUCCESS) {
+            env->ThrowNew(illegalStateExceptionClass_, recognizerErrorToString(status));
+        } else {
+            obj = newResultObject(env, result);
+        }
+        if(obj == NULL) {
+            env->DeleteLocalRef(results);
+            results = NULL;
+            break;
+        }
+        env->SetObjectArrayElement(results, (jsize) i, obj);
+        env->DeleteLocalRef(obj);
+    }
 
-			/* obtain string version of data in barcode */
-			status = recognizerResultGetBarcodeStringData(result, &str);
+    if(resultList != NULL) {
+        recognizerResultListDelete(&resultList);
+    }
+    return results;
+}
 
-			if (status != RECOGNIZER_ERROR_STATUS_SUCCESS) {
-				char err[1000];
-				sprintf(err, "Error obtaining barcode string data: %s", recognizerErrorToString(status));
-				return env->NewStringUTF(err);
-			}
+/* returns address of direct buffer holding at least size bytes, or NULL with pending IllegalArgumentException */
+static const void* getDirectBuffer(JNIEnv* env, jobject buffer, jlong size) {
+    const void* address = buffer != NULL ? env->GetDirectBufferAddress(buffer) : NULL;
+    if(address == NULL) {
+        env->ThrowNew(illegalArgumentExceptionClass_, "image must be in a direct ByteBuffer");
+        return NULL;
+    }
+    if(size <= 0 || size > env->GetDirectBufferCapacity(buffer)) {
+        env->ThrowNew(illegalArgumentExceptionClass_, "image size exceeds buffer capacity");
+        return NULL;
+    }
+    return address;
+}
 
-			LOGD("%s Result: %s\n", barcodeTypeToString(barcodeType), str);
+/* returns recognizer of the wrapper, or NULL with pending IllegalStateException */
+static Recognizer* checkRecognizer(JNIEnv* env, jobject thiz) {
+    Recognizer* recognizer = getRecognizer(env, thiz);
+    if(recognizer == NULL) {
+        env->ThrowNew(illegalStateExceptionClass_, "recognizer is not initialized");
+    }
+    return recognizer;
+}
 
-			ss << "Type: " << barcodeTypeToString(barcodeType) << std::endl << str << std::endl << std::endl;
-		}
-	}
+/*
+ * Class:     com_microblink_api_RecognizerWrapper
+ * Method:    recognizeEncodedImage
+ * Signature: (Ljava/nio/ByteBuffer;I)[Lcom/microblink/api/RecognizerResult;
+ */
+JNIEXPORT jobjectArray JNICALL Java_com_microblink_api_RecognizerWrapper_recognizeEncodedImage(JNIEnv* env, jobject thiz, jobject image, jint size) {
+    Recognizer* recognizer = checkRecognizer(env, thiz);
+    if(recognizer == NULL) {
+        return NULL;
+    }
+    const void* data = getDirectBuffer(env, image, size);
+    if(data == NULL) {
+        return NULL;
+    }
 
+    RecognizerResultList* resultList = NULL;
+    RecognizerErrorStatus status = recognizerRecognizeFromEncodedImage(recognizer, &resultList, data, (size_t) size, NULL);
+    return finishRecognition(env, status, resultList);
+}
 
-    jstring jStr;
-    // As of Android 4.4, you cannot blindly call NewStringUTF.
-    // If given non-UTF8 string, ART will crash.
-    std::string cppStr = ss.str();
-    if(utf8::is_valid(cppStr.begin(), cppStr.end())) {
-        jStr = env->NewStringUTF(cppStr.c_str());
-    } else {
-        // invalid UTF-8 string, attempt to convert literally
-        std::vector<jchar> wChars;
-        for(size_t i=0; i<cppStr.size(); ++i) {
-            wChars.push_back((jchar)cppStr[i]);
-        }
-        jStr = env->NewString(&wChars[0], wChars.size());
+/*
+ * Class:     com_microblink_api_RecognizerWrapper
+ * Method:    recognizeFrame
+ * Signature: (Ljava/nio/ByteBuffer;IIIIZ)[Lcom/microblink/api/RecognizerResult;
+ */
+JNIEXPORT jobjectArray JNICALL Java_com_microblink_api_RecognizerWrapper_recognizeFrame(JNIEnv* env, jobject thiz, jobject frame,
+        jint width, jint height, jint bytesPerRow, jint rawType, jboolean videoFrame) {
+    Recognizer* recognizer = checkRecognizer(env, thiz);
+    if(recognizer == NULL) {
+        return NULL;
     }
 
-    recognizerResultListDelete(&resultList);
+    jlong bytesPerPixel;
+    switch(rawType) {
+    case RAW_IMAGE_TYPE_BGRA:
+        bytesPerPixel = 4;
+        break;
+    case RAW_IMAGE_TYPE_BGR:
+        bytesPerPixel = 3;
+        break;
+    case RAW_IMAGE_TYPE_GRAY:
+    case RAW_IMAGE_TYPE_NV21:
+        bytesPerPixel = 1;
+        break;
+    default:
+        env->ThrowNew(illegalArgumentExceptionClass_, "unknown raw image type");
+        return NULL;
+    }
+    if(width <= 0 || height <= 0 || (jlong) bytesPerRow < (jlong) width * bytesPerPixel) {
+        env->ThrowNew(illegalArgumentExceptionClass_, "invalid frame dimensions");
+        return NULL;
+    }
+    /* NV21 has full resolution Y plane followed by interleaved V/U plane with half as many rows, rounded up */
+    jlong rows = height;
+    if(rawType == RAW_IMAGE_TYPE_NV21) {
+        rows += (rows + 1) / 2;
+    }
+    jlong size = (jlong) bytesPerRow * rows;
+    const void* data = getDirectBuffer(env, frame, size);
+    if(data == NULL) {
+        return NULL;
+    }
 
-    return jStr;
+    RecognizerResultList* resultList = NULL;
+    RecognizerErrorStatus status = recognizerRecognizeFromRawImage(recognizer, &resultList, data, width, height, (size_t) bytesPerRow,
+            (RawImageType) rawType, videoFrame ? 1 : 0, NULL);
+    return finishRecognition(env, status, resultList);
 }
 
 #ifdef __cplusplus
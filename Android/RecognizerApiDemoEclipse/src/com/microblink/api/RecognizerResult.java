@@ -0,0 +1,99 @@
+package com.microblink.api;
+
+import java.io.UnsupportedEncodingException;
+
+/**
+ * Single recognition result, created by native code in {@link RecognizerWrapper}.
+ *
+ * Objects are immutable and hold copies of the native result data, so they stay valid after
+ * the next recognition.
+ */
+public final class RecognizerResult {
+
+    private final boolean mUsdl;
+    private final String mType;
+    private final boolean mValid;
+    private final boolean mUncertain;
+    private final byte[] mData;
+    private final byte[] mExtendedData;
+    // USDL field keys (values of USDLFieldKeys) and their values, in USDLFieldKeysType order
+    private final String[] mFieldKeys;
+    private final String[] mFieldValues;
+
+    // called from native code, keep signature in sync with main.cpp
+    private RecognizerResult(boolean usdl, String type, boolean valid, boolean uncertain, byte[] data,
+            byte[] extendedData, String[] fieldKeys, String[] fieldValues) {
+        mUsdl = usdl;
+        mType = type;
+        mValid = valid;
+        mUncertain = uncertain;
+        mData = data;
+        mExtendedData = extendedData;
+        mFieldKeys = fieldKeys;
+        mFieldValues = fieldValues;
+    }
+
+    /** Returns true if result was produced by US Driver's License recognizer. */
+    public boolean isUsdl() {
+        return mUsdl;
+    }
+
+    /** Returns barcode type name, as given by barcodeTypeToString, or "USDL" for USDL results. */
+    public String getType() {
+        return mType;
+    }
+
+    public boolean isValid() {
+        return mValid;
+    }
+
+    public boolean isUncertain() {
+        return mUncertain;
+    }
+
+    /** Returns barcode raw data, or USDL raw data for USDL results. Never null. */
+    public byte[] getData() {
+        return mData;
+    }
+
+    /** Returns extended barcode data, or null if result does not have it. */
+    public byte[] getExtendedData() {
+        return mExtendedData;
+    }
+
+    /** Returns raw data decoded as UTF-8. */
+    public String getDataAsString() {
+        try {
+            return new String(mData, "UTF-8");
+        } catch (UnsupportedEncodingException e) {
+            // UTF-8 is always supported
+            throw new AssertionError(e);
+        }
+    }
+
+    /** Returns number of non-empty USDL fields. Zero for barcode results. */
+    public int getFieldCount() {
+        return mFieldKeys.length;
+    }
+
+    public String getFieldKey(int index) {
+        return mFieldKeys[index];
+    }
+
+    public String getFieldValue(int index) {
+        return mFieldValues[index];
+    }
+
+    /**
+     * Returns value of USDL field with given key (value of one of USDLFieldKeys members, e.g.
+     * USDLFieldKeys.kCustomerFirstName), or null if result does not contain the field.
+     */
+    public String getField(String key) {
+        for (int i = 0; i < mFieldKeys.length; ++i) {
+            if (mFieldKeys[i].equals(key)) {
+                return mFieldValues[i];
+            }
+        }
+        return null;
+    }
+}
@@ -1,9 +1,35 @@
 package com.microblink.api;
 
+import java.nio.ByteBuffer;
+
 import android.util.Log;
 
+/**
+ * Java binding of the native recognizer.
+ *
+ * Each wrapper owns a native recognizer, created by {@link #init()} and reused by every recognize call
+ * until {@link #terminate()}, so recognizer creation and license check are paid only once. All native
+ * methods are synchronized, so {@link #terminate()} called from another thread waits for a running
+ * recognition to finish instead of deleting the recognizer under it.
+ *
+ * Image bytes are passed in direct ByteBuffers, which native code reads in place without copying. For
+ * camera preview, allocate one direct buffer with {@link ByteBuffer#allocateDirect(int)}, copy each NV21
+ * frame into it (or receive frames into it directly) and pass it to {@link #recognizeFrame}.
+ *
+ * Recognition errors are thrown as {@link IllegalStateException}, invalid arguments as
+ * {@link IllegalArgumentException}.
+ */
 public class RecognizerWrapper {
 
+    /** Raw image types, values of RawImageType */
+    public static final int RAW_IMAGE_TYPE_BGRA = 0;
+    public static final int RAW_IMAGE_TYPE_BGR = 1;
+    public static final int RAW_IMAGE_TYPE_GRAY = 2;
+    public static final int RAW_IMAGE_TYPE_NV21 = 3;
+
+    // pointer to native Recognizer, owned and accessed only by native methods of this object
+    private long mNativeRecognizer = 0;
+
     static {
         try {
             System.loadLibrary("NativeRecognizer");
@@ -12,9 +38,41 @@ public class RecognizerWrapper {
         }
     }
 
-    public native String init();
+    /**
+     * Creates the native recognizer. Returns empty string on success, or error description.
+     */
+    public synchronized native String init();
+
+    public synchronized native void terminate();
+
+    /**
+     * Returns true if native recognizer was created by {@link #init()} and not yet terminated.
+     */
+    public synchronized boolean isInitialized() {
+        return mNativeRecognizer != 0;
+    }
+
+    /**
+     * Resets recognizer state accumulated from video frames. Call when frames of a new object start.
+     */
+    public synchronized native void reset();
 
-    public native void terminate();
+    /**
+     * Recognizes encoded image (JPEG, PNG, ...) stored in first size bytes of direct buffer.
+     */
+    public synchronized native RecognizerResult[] recognizeEncodedImage(ByteBuffer image, int size);
 
-    public native String recognize(byte[] bytes);
+    /**
+     * Recognizes raw frame stored at the beginning of direct buffer.
+     *
+     * @param frame         direct buffer holding the frame
+     * @param width         frame width in pixels
+     * @param height        frame height in pixels
+     * @param bytesPerRow   number of bytes in every row, equal to width for NV21 camera preview frames
+     * @param rawType       one of RAW_IMAGE_TYPE_* constants
+     * @param videoFrame    true if consecutive frames of the same object may be combined to improve
+     *                      the result, see imageIsVideoFrame in recognizerRecognizeFromRawImage
+     */
+    public synchronized native RecognizerResult[] recognizeFrame(ByteBuffer frame, int width, int height, int bytesPerRow,
+            int rawType, boolean videoFrame);
 }
@@ -0,0 +1,267 @@
+/*
+ * RecognizerClient.c
+ *
+ * Client library for recognizerd, see RecognizerClient.h.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "RecognizerClient.h"
+#include "RecognizerDaemonProtocol.h"
+
+struct RecognizerClient {
+    int fd;
+    /* body of the last response */
+    unsigned char* body;
+    size_t bodyCapacity;
+    /* results of the last successful recognition, read in place from body */
+    RecognizerResultListView results;
+};
+
+struct RecognizerClientFrame {
+    int fd;
+    void* data;
+    size_t capacity;
+};
+
+int recognizerClientConnect(RecognizerClient** client, const char* socketPath) {
+    struct sockaddr_un addr;
+    RecognizerClient* c;
+
+    if (client == NULL) return -EINVAL;
+    *client = NULL;
+    if (socketPath == NULL) socketPath = RECOGNIZERD_DEFAULT_SOCKET;
+    if (strlen(socketPath) >= sizeof(addr.sun_path)) return -ENAMETOOLONG;
+
+    c = (RecognizerClient*) calloc(1, sizeof(RecognizerClient));
+    if (c == NULL) return -ENOMEM;
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socketPath);
+
+    c->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (c->fd < 0 || connect(c->fd, (struct sockaddr*) &addr, sizeof(addr)) != 0) {
+        int err = errno;
+        if (c->fd >= 0) close(c->fd);
+        free(c);
+        return -err;
+    }
+    *client = c;
+    return 0;
+}
+
+void recognizerClientDelete(RecognizerClient** client) {
+    if (client == NULL || *client == NULL) return;
+    close((*client)->fd);
+    free((*client)->body);
+    free(*client);
+    *client = NULL;
+}
+
+int recognizerClientFrameCreate(RecognizerClientFrame** frame, size_t capacity) {
+    RecognizerClientFrame* f;
+    int err;
+
+    if (frame == NULL || capacity == 0) return -EINVAL;
+    *frame = NULL;
+
+    f = (RecognizerClientFrame*) calloc(1, sizeof(RecognizerClientFrame));
+    if (f == NULL) return -ENOMEM;
+
+    f->fd = memfd_create("recognizer-frame", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if (f->fd < 0) {
+        err = errno;
+        free(f);
+        return -err;
+    }
+    /* daemon maps the frame only if it can never shrink */
+    if (ftruncate(f->fd, (off_t) capacity) != 0 || fcntl(f->fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) != 0) {
+        err = errno;
+        close(f->fd);
+        free(f);
+        return -err;
+    }
+    f->data = mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, f->fd, 0);
+    if (f->data == MAP_FAILED) {
+        err = errno;
+        close(f->fd);
+        free(f);
+        return -err;
+    }
+    f->capacity = capacity;
+    *frame = f;
+    return 0;
+}
+
+void recognizerClientFrameDelete(RecognizerClientFrame** frame) {
+    if (frame == NULL || *frame == NULL) return;
+    munmap((*frame)->data, (*frame)->capacity);
+    close((*frame)->fd);
+    free(*frame);
+    *frame = NULL;
+}
+
+void* recognizerClientFrameGetData(RecognizerClientFrame* frame) {
+    return frame != NULL ? frame->data : NULL;
+}
+
+size_t recognizerClientFrameGetCapacity(const RecognizerClientFrame* frame) {
+    return frame != NULL ? frame->capacity : 0;
+}
+
+static int writeFull(int fd, const void* buffer, size_t size) {
+    const char* p = (const char*) buffer;
+    while (size > 0) {
+        ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return -errno;
+        if (n == 0) return -EPIPE;
+        p += n;
+        size -= (size_t) n;
+    }
+    return 0;
+}
+
+static int readFull(int fd, void* buffer, size_t size) {
+    char* p = (char*) buffer;
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) return -errno;
+        if (n == 0) return -ECONNRESET;
+        p += n;
+        size -= (size_t) n;
+    }
+    return 0;
+}
+
+static int sendRequest(RecognizerClient* client, const RecognizerdRequest* request, int imageFd) {
+    union {
+        struct cmsghdr align;
+        char buffer[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct msghdr msg;
+    struct iovec iov;
+    ssize_t n;
+
+    memset(&msg, 0, sizeof(msg));
+    iov.iov_base = (void*) request;
+    iov.iov_len = sizeof(*request);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    if (imageFd >= 0) {
+        struct cmsghdr* cmsg;
+        memset(&control, 0, sizeof(control));
+        msg.msg_control = control.buffer;
+        msg.msg_controllen = sizeof(control.buffer);
+        cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &imageFd, sizeof(int));
+    }
+
+    do {
+        n = sendmsg(client->fd, &msg, MSG_NOSIGNAL);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0) return -errno;
+    /* descriptor is attached to the first byte, the rest may go as plain data */
+    if ((size_t) n < sizeof(*request)) {
+        return writeFull(client->fd, (const char*) request + n, sizeof(*request) - (size_t) n);
+    }
+    return 0;
+}
+
+/* reads response and opens results in it */
+static int receiveResponse(RecognizerClient* client, RecognizerErrorStatus* status) {
+    RecognizerdResponse response;
+    int err;
+
+    memset(&client->results, 0, sizeof(client->results));
+
+    err = readFull(client->fd, &response, sizeof(response));
+    if (err != 0) return err;
+    if (response.magic != RECOGNIZERD_MAGIC || response.version != RECOGNIZERD_PROTOCOL_VERSION) return -EPROTO;
+
+    if (response.length > client->bodyCapacity) {
+        unsigned char* body = (unsigned char*) realloc(client->body, response.length);
+        if (body == NULL) return -ENOMEM;
+        client->body = body;
+        client->bodyCapacity = response.length;
+    }
+    err = readFull(client->fd, client->body, response.length);
+    if (err != 0) return err;
+
+    if (status != NULL) *status = (RecognizerErrorStatus) response.status;
+    if (response.status != RECOGNIZER_ERROR_STATUS_SUCCESS) return 0;
+
+    if (recognizerResultListDeserialize(client->body, response.length, &client->results) != RECOGNIZER_ERROR_STATUS_SUCCESS) return -EPROTO;
+    return 0;
+}
+
+static void initRequest(RecognizerdRequest* request, RecognizerdImageKind kind, size_t size) {
+    memset(request, 0, sizeof(*request));
+    request->magic = RECOGNIZERD_MAGIC;
+    request->version = RECOGNIZERD_PROTOCOL_VERSION;
+    request->imageKind = (uint16_t) kind;
+    request->size = size;
+}
+
+int recognizerClientRecognizeEncodedFrame(RecognizerClient* client, const RecognizerClientFrame* frame, size_t size,
+        RecognizerErrorStatus* status) {
+    RecognizerdRequest request;
+    int err;
+    if (client == NULL || frame == NULL || size == 0 || size > frame->capacity) return -EINVAL;
+    initRequest(&request, RECOGNIZERD_IMAGE_ENCODED, size);
+    err = sendRequest(client, &request, frame->fd);
+    return err != 0 ? err : receiveResponse(client, status);
+}
+
+int recognizerClientRecognizeRawFrame(RecognizerClient* client, const RecognizerClientFrame* frame,
+        int width, int height, size_t bytesPerRow, RawImageType rawType, RecognizerErrorStatus* status) {
+    RecognizerdRequest request;
+    int err;
+    if (client == NULL || frame == NULL) return -EINVAL;
+    initRequest(&request, RECOGNIZERD_IMAGE_RAW, frame->capacity);
+    request.width = width;
+    request.height = height;
+    request.bytesPerRow = bytesPerRow;
+    request.rawType = (int32_t) rawType;
+    err = sendRequest(client, &request, frame->fd);
+    return err != 0 ? err : receiveResponse(client, status);
+}
+
+int recognizerClientRecognizeEncodedImage(RecognizerClient* client, const void* image, size_t size,
+        RecognizerErrorStatus* status) {
+    RecognizerdRequest request;
+    int err;
+    if (client == NULL || image == NULL || size == 0) return -EINVAL;
+    initRequest(&request, RECOGNIZERD_IMAGE_ENCODED, size);
+    request.flags = RECOGNIZERD_REQUEST_INLINE;
+    err = sendRequest(client, &request, -1);
+    if (err == 0) err = writeFull(client->fd, image, size);
+    return err != 0 ? err : receiveResponse(client, status);
+}
+
+size_t recognizerClientGetNumOfResults(const RecognizerClient* client) {
+    return client != NULL ? client->results.numResults : 0;
+}
+
+int recognizerClientGetResultAtIndex(const RecognizerClient* client, size_t index, RecognizerResultView* result) {
+    if (client == NULL || result == NULL) return -EINVAL;
+    switch (recognizerResultListViewGetResultAtIndex(&client->results, index, result)) {
+        case RECOGNIZER_ERROR_STATUS_SUCCESS: return 0;
+        case RECOGNIZER_ERROR_STATUS_INDEX_OUT_OF_RANGE: return -ERANGE;
+        default: return -EPROTO;
+    }
+}
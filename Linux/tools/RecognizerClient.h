@@ -0,0 +1,124 @@
+/**
+ * @file RecognizerClient.h
+ *
+ * Client library for recognizerd. Does not depend on RecognizerApi library, only on its headers,
+ * so it can be linked into any process on the host (also through ctypes, JNA and similar).
+ *
+ * Functions return 0 on success or negative errno value on communication failure. After a
+ * communication failure the client should be deleted and connected again. Status of the
+ * recognition itself is returned separately as RecognizerErrorStatus.
+ *
+ * A single RecognizerClient must not be used from multiple threads at the same time. Open one
+ * client per thread instead, daemon serves them concurrently.
+ */
+
+#ifndef RECOGNIZERCLIENT_H_
+#define RECOGNIZERCLIENT_H_
+
+#include <stddef.h>
+
+#include "RecognizerApi.h"
+#include "RecognizerResultSerialization.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @struct RecognizerClient
+ * @brief Connection to recognizerd.
+ */
+typedef struct RecognizerClient RecognizerClient;
+
+/**
+ * @struct RecognizerClientFrame
+ * @brief Shared memory buffer for passing images to daemon without copying.
+ *
+ * Frame is backed by a sealed memfd. Write the image directly into the buffer returned by
+ * ::recognizerClientFrameGetData and pass the frame to ::recognizerClientRecognizeEncodedFrame or
+ * ::recognizerClientRecognizeRawFrame. Frame can be reused for any number of requests.
+ */
+typedef struct RecognizerClientFrame RecognizerClientFrame;
+
+/**
+ * @brief Connects to daemon listening on given socket path.
+ * @param client        [out] created client. On failure set to NULL.
+ * @param socketPath    socket path, or NULL for default path (RECOGNIZERD_DEFAULT_SOCKET)
+ * @return 0 on success, negative errno value otherwise
+ */
+int recognizerClientConnect(RecognizerClient** client, const char* socketPath);
+
+/**
+ * @brief Closes connection, deletes the client and sets pointer to it to NULL.
+ */
+void recognizerClientDelete(RecognizerClient** client);
+
+/**
+ * @brief Allocates shared memory frame with given capacity.
+ * @param frame     [out] created frame. On failure set to NULL.
+ * @param capacity  size of the frame buffer in bytes
+ * @return 0 on success, negative errno value otherwise
+ */
+int recognizerClientFrameCreate(RecognizerClientFrame** frame, size_t capacity);
+
+/**
+ * @brief Unmaps and deletes the frame and sets pointer to it to NULL.
+ */
+void recognizerClientFrameDelete(RecognizerClientFrame** frame);
+
+/**
+ * @brief Returns writable buffer of the frame.
+ */
+void* recognizerClientFrameGetData(RecognizerClientFrame* frame);
+
+/**
+ * @brief Returns capacity of the frame buffer in bytes.
+ */
+size_t recognizerClientFrameGetCapacity(const RecognizerClientFrame* frame);
+
+/**
+ * @brief Recognizes encoded image (see recognizerRecognizeFromEncodedImage) stored in first size bytes of frame.
+ * @param client    connected client
+ * @param frame     frame holding the image
+ * @param size      number of image bytes in frame
+ * @param status    [out] status of the recognition
+ * @return 0 on success, negative errno value on communication failure
+ */
+int recognizerClientRecognizeEncodedFrame(RecognizerClient* client, const RecognizerClientFrame* frame, size_t size,
+        RecognizerErrorStatus* status);
+
+/**
+ * @brief Recognizes raw image (see recognizerRecognizeFromRawImage) stored at the beginning of frame.
+ * @return 0 on success, negative errno value on communication failure
+ */
+int recognizerClientRecognizeRawFrame(RecognizerClient* client, const RecognizerClientFrame* frame,
+        int width, int height, size_t bytesPerRow, RawImageType rawType, RecognizerErrorStatus* status);
+
+/**
+ * @brief Recognizes encoded image by sending its bytes over the socket.
+ * Use this when image is not already in a frame and is used only once.
+ * @return 0 on success, negative errno value on communication failure
+ */
+int recognizerClientRecognizeEncodedImage(RecognizerClient* client, const void* image, size_t size,
+        RecognizerErrorStatus* status);
+
+/**
+ * @brief Returns number of results of the last successful recognition.
+ */
+size_t recognizerClientGetNumOfResults(const RecognizerClient* client);
+
+/**
+ * @brief Obtains result of the last recognition at given index.
+ *
+ * Result view points into the client's response buffer and is valid until the next request
+ * made with the same client. USDL fields can be read with recognizerResultViewGetUSDLField.
+ *
+ * @return 0 on success, -ERANGE if index is out of range, -EPROTO if result record is malformed
+ */
+int recognizerClientGetResultAtIndex(const RecognizerClient* client, size_t index, RecognizerResultView* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * @file RecognizerDaemonProtocol.h
+ *
+ * Wire protocol spoken between recognizerd and its clients over a Unix domain stream socket.
+ *
+ * Each request is a RecognizerdRequest header. Image bytes are either passed as a memfd attached
+ * to the header with SCM_RIGHTS (zero-copy, the daemon maps the file read-only), or follow the
+ * header inline when RECOGNIZERD_REQUEST_INLINE is set. The memfd must be sealed with F_SEAL_SHRINK
+ * so that it cannot be truncated while the daemon reads from it.
+ *
+ * Each request is answered with a RecognizerdResponse header followed by length bytes of results,
+ * serialized with recognizerResultListSerialize (see RecognizerResultSerialization.h). If recognition
+ * failed, length is zero.
+ *
+ * All integers are in host byte order, since both sides always run on the same machine.
+ */
+
+#ifndef RECOGNIZERDAEMONPROTOCOL_H_
+#define RECOGNIZERDAEMONPROTOCOL_H_
+
+#include <stdint.h>
+
+/** "RCGD" */
+#define RECOGNIZERD_MAGIC 0x44474352u
+
+#define RECOGNIZERD_PROTOCOL_VERSION 2
+
+#define RECOGNIZERD_DEFAULT_SOCKET "/tmp/recognizerd.sock"
+
+/** Request flag: image bytes follow the request header instead of being passed as memfd */
+#define RECOGNIZERD_REQUEST_INLINE 1u
+
+/**
+ * @enum RecognizerdImageKind
+ * @brief Defines how image bytes in request are interpreted.
+ */
+typedef enum RecognizerdImageKind {
+    /** Image in one of the encodings supported by recognizerRecognizeFromEncodedImage */
+    RECOGNIZERD_IMAGE_ENCODED = 0,
+    /** Raw pixels, as given to recognizerRecognizeFromRawImage */
+    RECOGNIZERD_IMAGE_RAW = 1
+} RecognizerdImageKind;
+
+/**
+ * @struct RecognizerdRequest
+ * @brief Request header sent by client.
+ */
+typedef struct RecognizerdRequest {
+    /** must be RECOGNIZERD_MAGIC */
+    uint32_t magic;
+    /** must be RECOGNIZERD_PROTOCOL_VERSION */
+    uint16_t version;
+    /** one of RecognizerdImageKind values */
+    uint16_t imageKind;
+    /** combination of RECOGNIZERD_REQUEST_* flags */
+    uint32_t flags;
+    /** raw image width in pixels, ignored for encoded images */
+    int32_t width;
+    /** raw image height in pixels, ignored for encoded images */
+    int32_t height;
+    /** RawImageType of raw image, ignored for encoded images */
+    int32_t rawType;
+    /** number of bytes in every row of raw image, ignored for encoded images */
+    uint64_t bytesPerRow;
+    /** number of image bytes, inline or at the beginning of memfd */
+    uint64_t size;
+} RecognizerdRequest;
+
+/**
+ * @struct RecognizerdResponse
+ * @brief Response header sent by daemon.
+ */
+typedef struct RecognizerdResponse {
+    /** always RECOGNIZERD_MAGIC */
+    uint32_t magic;
+    /** always RECOGNIZERD_PROTOCOL_VERSION */
+    uint16_t version;
+    uint16_t reserved;
+    /** RecognizerErrorStatus of recognition */
+    int32_t status;
+    /** number of result bytes following this header */
+    uint32_t length;
+} RecognizerdResponse;
+
+#endif
@@ -0,0 +1,206 @@
+/*
+ * RecognizerResultJson.c
+ *
+ * Direct JSON output of result lists, see RecognizerResultJson.h.
+ */
+
+#include <string.h>
+
+#include "RecognizerResultJson.h"
+
+/* number of fields in USDLFieldKeysType */
+#define USDL_NUM_FIELDS (sizeof(struct USDLFieldKeysType) / sizeof(const char*))
+
+/* writes only while there is room, but always advances position so total size is known */
+typedef struct JsonWriter {
+    char* buffer;
+    size_t capacity;
+    size_t pos;
+} JsonWriter;
+
+static void put(JsonWriter* w, const char* s, size_t len) {
+    if (w->pos < w->capacity) {
+        size_t room = w->capacity - w->pos;
+        memcpy(w->buffer + w->pos, s, len < room ? len : room);
+    }
+    w->pos += len;
+}
+
+static void putLiteral(JsonWriter* w, const char* s) {
+    put(w, s, strlen(s));
+}
+
+static void putBool(JsonWriter* w, int value) {
+    if (value) put(w, "true", 4); else put(w, "false", 5);
+}
+
+/* length of the valid UTF-8 sequence starting at s, or 0 if the sequence is invalid */
+static size_t utf8SequenceLength(const unsigned char* s, size_t avail) {
+    size_t len, i;
+    unsigned int cp;
+    if (s[0] < 0x80) return 1;
+    if (s[0] >= 0xC2 && s[0] <= 0xDF) { len = 2; cp = s[0] & 0x1F; }
+    else if (s[0] >= 0xE0 && s[0] <= 0xEF) { len = 3; cp = s[0] & 0x0F; }
+    else if (s[0] >= 0xF0 && s[0] <= 0xF4) { len = 4; cp = s[0] & 0x07; }
+    else return 0;
+    if (len > avail) return 0;
+    for (i = 1; i < len; ++i) {
+        if ((s[i] & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (s[i] & 0x3F);
+    }
+    /* reject overlong forms, surrogates and code points above U+10FFFF */
+    if ((len == 3 && cp < 0x800) || (len == 4 && (cp < 0x10000 || cp > 0x10FFFF)) || (cp >= 0xD800 && cp <= 0xDFFF)) return 0;
+    return len;
+}
+
+static void putString(JsonWriter* w, const void* data, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    const unsigned char* s = (const unsigned char*) data;
+    size_t i = 0;
+    put(w, "\"", 1);
+    while (i < len) {
+        size_t run = i;
+        unsigned char c;
+        size_t seq;
+        /* copy runs of plain ASCII at once, they are the common case */
+        while (run < len && s[run] >= 0x20 && s[run] < 0x80 && s[run] != '"' && s[run] != '\\') ++run;
+        if (run > i) {
+            put(w, (const char*) s + i, run - i);
+            i = run;
+            continue;
+        }
+        c = s[i];
+        if (c == '"' || c == '\\') {
+            char esc[2];
+            esc[0] = '\\'; esc[1] = (char) c;
+            put(w, esc, 2);
+            ++i;
+        } else if (c == '\n') {
+            put(w, "\\n", 2);
+            ++i;
+        } else if (c == '\r') {
+            put(w, "\\r", 2);
+            ++i;
+        } else if (c == '\t') {
+            put(w, "\\t", 2);
+            ++i;
+        } else if (c >= 0x80 && (seq = utf8SequenceLength(s + i, len - i)) > 0) {
+            put(w, (const char*) s + i, seq);
+            i += seq;
+        } else {
+            /* other control characters and bytes outside valid UTF-8 */
+            char esc[6];
+            esc[0] = '\\'; esc[1] = 'u'; esc[2] = '0'; esc[3] = '0';
+            esc[4] = hex[c >> 4]; esc[5] = hex[c & 0xF];
+            put(w, esc, 6);
+            ++i;
+        }
+    }
+    put(w, "\"", 1);
+}
+
+static void putCString(JsonWriter* w, const char* s) {
+    putString(w, s, strlen(s));
+}
+
+static void putResult(JsonWriter* w, RecognizerResult* result) {
+    const void* raw = NULL;
+    size_t rawSize = 0;
+    int isUsdl = 0;
+    int valid = 0;
+    int uncertain = 0;
+
+    recognizerResultIsResultValid(result, &valid);
+    recognizerResultIsResultUncertain(result, &uncertain);
+
+    if (recognizerResultIsUSDLResult(result, &isUsdl) == RECOGNIZER_ERROR_STATUS_SUCCESS && isUsdl) {
+        const char* const* keys = (const char* const*) &USDLFieldKeys;
+        int first = 1;
+        size_t i;
+
+        putLiteral(w, "{\"type\":\"USDL\",\"valid\":");
+        putBool(w, valid);
+        putLiteral(w, ",\"uncertain\":");
+        putBool(w, uncertain);
+        if (recognizerResultGetUSDLRawBinaryData(result, &raw, &rawSize) == RECOGNIZER_ERROR_STATUS_SUCCESS && raw != NULL) {
+            putLiteral(w, ",\"data\":");
+            putString(w, raw, rawSize);
+        }
+        putLiteral(w, ",\"fields\":{");
+        for (i = 0; i < USDL_NUM_FIELDS; ++i) {
+            const char* value = NULL;
+            if (keys[i] == NULL || recognizerResultGetUSDLField(result, &value, keys[i]) != RECOGNIZER_ERROR_STATUS_SUCCESS || value == NULL || value[0] == '\0') continue;
+            if (!first) put(w, ",", 1);
+            first = 0;
+            putCString(w, keys[i]);
+            put(w, ":", 1);
+            putCString(w, value);
+        }
+        putLiteral(w, "}}");
+    } else {
+        BarcodeType barcodeType;
+        const void* extended = NULL;
+        size_t extendedSize = 0;
+
+        putLiteral(w, "{\"type\":");
+        if (recognizerResultGetBarcodeType(result, &barcodeType) == RECOGNIZER_ERROR_STATUS_SUCCESS) {
+            putCString(w, barcodeTypeToString(barcodeType));
+        } else {
+            putLiteral(w, "null");
+        }
+        putLiteral(w, ",\"valid\":");
+        putBool(w, valid);
+        putLiteral(w, ",\"uncertain\":");
+        putBool(w, uncertain);
+        if (recognizerResultGetBarcodeRawData(result, &raw, &rawSize) == RECOGNIZER_ERROR_STATUS_SUCCESS && raw != NULL) {
+            putLiteral(w, ",\"data\":");
+            putString(w, raw, rawSize);
+        }
+        if (recognizerResultGetBarcodeExtendedRawData(result, &extended, &extendedSize) == RECOGNIZER_ERROR_STATUS_SUCCESS && extended != NULL) {
+            putLiteral(w, ",\"extendedData\":");
+            putString(w, extended, extendedSize);
+        }
+        put(w, "}", 1);
+    }
+}
+
+RecognizerErrorStatus recognizerResultListToJson(const RecognizerResultList* resultList, char* buffer, size_t capacity, size_t* needed) {
+    JsonWriter w;
+    size_t numResults = 0;
+    size_t i;
+
+    if (needed == NULL) return RECOGNIZER_ERROR_STATUS_POINTER_IS_NULL;
+
+    w.buffer = buffer;
+    w.capacity = buffer != NULL ? capacity : 0;
+    w.pos = 0;
+
+    if (resultList != NULL) recognizerResultListGetNumOfResults(resultList, &numResults);
+
+    put(&w, "[", 1);
+    for (i = 0; i < numResults; ++i) {
+        RecognizerResult* result;
+        if (recognizerResultListGetResultAtIndex(resultList, i, &result) != RECOGNIZER_ERROR_STATUS_SUCCESS) return RECOGNIZER_ERROR_STATUS_FAIL;
+        if (i > 0) put(&w, ",", 1);
+        putResult(&w, result);
+    }
+    put(&w, "]", 1);
+    put(&w, "", 1);
+
+    *needed = w.pos;
+    return w.pos <= w.capacity ? RECOGNIZER_ERROR_STATUS_SUCCESS : RECOGNIZER_ERROR_STATUS_FAIL;
+}
+
+RecognizerErrorStatus recognizerJsonWriteString(const void* data, size_t size, char* buffer, size_t capacity, size_t* needed) {
+    JsonWriter w;
+
+    if (needed == NULL || (data == NULL && size > 0)) return RECOGNIZER_ERROR_STATUS_POINTER_IS_NULL;
+
+    w.buffer = buffer;
+    w.capacity = buffer != NULL ? capacity : 0;
+    w.pos = 0;
+    putString(&w, data, size);
+
+    *needed = w.pos;
+    return w.pos <= w.capacity ? RECOGNIZER_ERROR_STATUS_SUCCESS : RECOGNIZER_ERROR_STATUS_FAIL;
+}
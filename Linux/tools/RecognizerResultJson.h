@@ -0,0 +1,72 @@
+/**
+ * @file RecognizerResultJson.h
+ *
+ * Direct JSON output of RecognizerResultList, written in one pass into a caller provided buffer.
+ *
+ * List is written as an array with one object per result:
+ *
+ *      {"type":"QR Code","valid":true,"uncertain":false,"data":"...","extendedData":"..."}
+ *      {"type":"USDL","valid":true,"uncertain":false,"data":"...","fields":{"<key>":"<value>",...}}
+ *
+ * extendedData is present only for results that have it. USDL field names are the values of
+ * USDLFieldKeys (e.g. the value of USDLFieldKeys.kCustomerFirstName), in USDLFieldKeysType order;
+ * empty fields are omitted. Valid UTF-8 is copied as is, bytes that are not part of a valid UTF-8
+ * sequence are written as \u00XX, i.e. interpreted as Latin-1.
+ */
+
+#ifndef RECOGNIZERRESULTJSON_H_
+#define RECOGNIZERRESULTJSON_H_
+
+#include <stddef.h>
+
+#include "RecognizerApi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @memberof RecognizerResultList
+ * @brief Writes result list as zero-terminated JSON into caller provided buffer.
+ *
+ * To query required size, call with NULL buffer and zero capacity. Writing never allocates memory.
+ *
+ * Example:
+ * @code
+ *  size_t needed;
+ *  char* json;
+ *  recognizerResultListToJson(resultList, NULL, 0, &needed);
+ *  json = (char*) malloc(needed);
+ *  recognizerResultListToJson(resultList, json, needed, &needed);
+ * @endcode
+ *
+ * @param resultList    list to write. NULL is written as empty array.
+ * @param buffer        destination buffer, may be NULL if capacity is 0
+ * @param capacity      size of buffer in bytes
+ * @param needed        [out] number of bytes required for JSON, including terminating zero
+ * @return RECOGNIZER_ERROR_STATUS_SUCCESS if JSON was written, RECOGNIZER_ERROR_STATUS_FAIL if capacity is
+ *         smaller than needed (buffer contents are then unspecified), RECOGNIZER_ERROR_STATUS_POINTER_IS_NULL
+ *         if needed is NULL.
+ */
+RecognizerErrorStatus recognizerResultListToJson(const RecognizerResultList* resultList, char* buffer, size_t capacity, size_t* needed);
+
+/**
+ * @brief Writes bytes as quoted JSON string, escaped the same way as strings in ::recognizerResultListToJson.
+ *
+ * Output is not zero-terminated. Writing stops when capacity is reached, but needed is always
+ * set to the full length.
+ *
+ * @param data      bytes to write
+ * @param size      number of bytes
+ * @param buffer    destination buffer, may be NULL if capacity is 0
+ * @param capacity  size of buffer in bytes
+ * @param needed    [out] length of the quoted string
+ * @return RECOGNIZER_ERROR_STATUS_SUCCESS if string was written completely, RECOGNIZER_ERROR_STATUS_FAIL otherwise
+ */
+RecognizerErrorStatus recognizerJsonWriteString(const void* data, size_t size, char* buffer, size_t capacity, size_t* needed);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,169 @@
+/**
+ * @file RecognizerResultSerialization.h
+ *
+ * Compact binary serialization of RecognizerResultList for passing results between processes.
+ *
+ * Serialized list is a single contiguous buffer that is read in place: views returned by
+ * ::recognizerResultListDeserialize and ::recognizerResultListViewGetResultAtIndex point directly
+ * into the buffer, so nothing is copied or allocated on the receiving side. All byte strings in
+ * the buffer are zero-terminated, so they can be used directly as C strings.
+ *
+ * Layout (all integers little-endian, offsets relative to start of the buffer or record):
+ *
+ *      list header     u32 magic "PPRL", u16 version, u16 header size, u32 total size,
+ *                      u32 number of results, u32 reserved
+ *      offset table    u32 offset of each result record
+ *      result record   u32 record size, u8 kind, u8 barcode type, u8 flags, u8 reserved,
+ *                      u32 raw data size, u32 extended data size, u32 number of USDL fields,
+ *                      USDL field table of (u16 field index, u16 reserved, u32 value offset, u32 value size),
+ *                      raw data + '\0', extended data + '\0' (if present), USDL field values + '\0'
+ *
+ * Readers accept any header size not smaller than the one defined here, so fields can be
+ * appended to the list header in later versions.
+ *
+ * USDL fields are identified by their index in USDLFieldKeysType, which never changes (see the note
+ * above USDLFieldKeysType in RecognizerResult.h). Use ::RECOGNIZER_USDL_FIELD_INDEX to obtain it.
+ *
+ * Detected object geometry is not part of the format because RecognizerResult does not expose it.
+ */
+
+#ifndef RECOGNIZERRESULTSERIALIZATION_H_
+#define RECOGNIZERRESULTSERIALIZATION_H_
+
+#include <stddef.h>
+
+#include "RecognizerApi.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Version of serialization format written by ::recognizerResultListSerialize */
+#define RECOGNIZER_RESULT_LIST_FORMAT_VERSION 1
+
+/** "PPRL" */
+#define RECOGNIZER_RESULT_LIST_MAGIC 0x4C525050u
+#define RECOGNIZER_RESULT_LIST_HEADER_SIZE 20
+#define RECOGNIZER_RESULT_RECORD_HEADER_SIZE 20
+#define RECOGNIZER_RESULT_FIELD_ENTRY_SIZE 12
+
+#define RECOGNIZER_RESULT_FLAG_UNCERTAIN 1u
+#define RECOGNIZER_RESULT_FLAG_VALID 2u
+#define RECOGNIZER_RESULT_FLAG_EXTENDED 4u
+
+#define RECOGNIZER_RESULT_KIND_BARCODE 0
+#define RECOGNIZER_RESULT_KIND_USDL 1
+
+/** Number of fields in USDLFieldKeysType */
+#define RECOGNIZER_USDL_NUM_FIELDS (sizeof(struct USDLFieldKeysType) / sizeof(const char*))
+
+/** Index of USDL field key in USDLFieldKeysType, e.g. RECOGNIZER_USDL_FIELD_INDEX(kCustomerFirstName) */
+#define RECOGNIZER_USDL_FIELD_INDEX(key) (offsetof(struct USDLFieldKeysType, key) / sizeof(const char*))
+
+/**
+ * @struct RecognizerResultListView
+ * @brief Serialized result list, read in place.
+ */
+typedef struct RecognizerResultListView {
+    /** serialized buffer */
+    const unsigned char* data;
+    /** size of the serialized list in bytes */
+    size_t size;
+    /** start of the offset table */
+    size_t offsetsStart;
+    /** number of results in list */
+    size_t numResults;
+} RecognizerResultListView;
+
+/**
+ * @struct RecognizerResultView
+ * @brief Single serialized result, read in place. All pointers point into the serialized buffer.
+ */
+typedef struct RecognizerResultView {
+    /** non-zero if result was produced by US Driver's License recognizer */
+    int isUsdl;
+    /** type of barcode, BARCODE_TYPE_PDF417 for USDL results */
+    BarcodeType barcodeType;
+    /** non-zero if result is uncertain, see recognizerResultIsResultUncertain */
+    int uncertain;
+    /** non-zero if result is valid, see recognizerResultIsResultValid */
+    int valid;
+    /** barcode raw data, or USDL raw binary data for USDL results. Zero-terminated. */
+    const char* rawData;
+    /** size of raw data, without terminating zero */
+    size_t rawDataSize;
+    /** extended barcode data, NULL if result does not have it. Zero-terminated. */
+    const char* extendedData;
+    /** size of extended data, without terminating zero */
+    size_t extendedDataSize;
+    /** number of USDL fields present in result */
+    size_t numUsdlFields;
+    /** start of the record, used by USDL field accessors */
+    const unsigned char* record;
+} RecognizerResultView;
+
+/**
+ * @memberof RecognizerResultList
+ * @brief Serializes result list into caller provided buffer.
+ *
+ * To query required size, call with NULL buffer and zero capacity. Serialization never allocates memory.
+ *
+ * @param resultList    list to serialize. NULL is serialized as empty list.
+ * @param buffer        destination buffer, may be NULL if capacity is 0
+ * @param capacity      size of buffer in bytes
+ * @param needed        [out] number of bytes required for serialized list
+ * @return RECOGNIZER_ERROR_STATUS_SUCCESS if list was written, RECOGNIZER_ERROR_STATUS_FAIL if capacity is
+ *         smaller than needed (buffer contents are then unspecified), RECOGNIZER_ERROR_STATUS_POINTER_IS_NULL
+ *         if needed is NULL.
+ */
+RecognizerErrorStatus recognizerResultListSerialize(const RecognizerResultList* resultList, void* buffer, size_t capacity, size_t* needed);
+
+/**
+ * @memberof RecognizerResultListView
+ * @brief Opens serialized list for reading in place. Does not depend on RecognizerApi library.
+ *
+ * Only the list header and offset table are checked here, each result is checked when it is accessed.
+ *
+ * @param buffer    serialized list, must stay alive while view and result views are used
+ * @param size      number of bytes available in buffer
+ * @param view      [out] list view
+ * @return RECOGNIZER_ERROR_STATUS_SUCCESS on success, RECOGNIZER_ERROR_STATUS_INVALID_TYPE if buffer does not
+ *         contain supported serialized list, RECOGNIZER_ERROR_STATUS_POINTER_IS_NULL if any pointer is NULL.
+ */
+RecognizerErrorStatus recognizerResultListDeserialize(const void* buffer, size_t size, RecognizerResultListView* view);
+
+/**
+ * @memberof RecognizerResultListView
+ * @brief Obtains view of the result at given index.
+ * @return RECOGNIZER_ERROR_STATUS_SUCCESS on success, RECOGNIZER_ERROR_STATUS_INDEX_OUT_OF_RANGE if index is out of
+ *         range, RECOGNIZER_ERROR_STATUS_INVALID_TYPE if record is malformed.
+ */
+RecognizerErrorStatus recognizerResultListViewGetResultAtIndex(const RecognizerResultListView* view, size_t index, RecognizerResultView* result);
+
+/**
+ * @memberof RecognizerResultView
+ * @brief Obtains USDL field by its index in USDLFieldKeysType.
+ *
+ * Example:
+ * @code
+ *  const char* firstName;
+ *  recognizerResultViewGetUSDLField(&result, RECOGNIZER_USDL_FIELD_INDEX(kCustomerFirstName), &firstName);
+ * @endcode
+ *
+ * @return RECOGNIZER_ERROR_STATUS_SUCCESS if field is present, RECOGNIZER_ERROR_STATUS_UNKNOWN_KEY if it is not
+ *         (value is then set to NULL), RECOGNIZER_ERROR_STATUS_INVALID_TYPE if result is not USDL result.
+ */
+RecognizerErrorStatus recognizerResultViewGetUSDLField(const RecognizerResultView* result, size_t fieldIndex, const char** value);
+
+/**
+ * @memberof RecognizerResultView
+ * @brief Obtains i-th USDL field present in result, for iterating over all fields. Fields are ordered by field index.
+ * @return RECOGNIZER_ERROR_STATUS_SUCCESS on success, RECOGNIZER_ERROR_STATUS_INDEX_OUT_OF_RANGE if i is out of range.
+ */
+RecognizerErrorStatus recognizerResultViewGetUSDLFieldAt(const RecognizerResultView* result, size_t i, size_t* fieldIndex, const char** value, size_t* valueSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * RecognizerResultSerialize.c
+ *
+ * Writing side of result list serialization, see RecognizerResultSerialization.h.
+ */
+
+#include <string.h>
+
+#include "RecognizerResultSerialization.h"
+
+/* writes only while there is room, but always advances position so total size is known */
+typedef struct Writer {
+    unsigned char* buffer;
+    size_t capacity;
+    size_t pos;
+} Writer;
+
+static void putBytes(Writer* w, size_t at, const void* data, size_t size) {
+    if (w->buffer != NULL && at <= w->capacity && size <= w->capacity - at) {
+        memcpy(w->buffer + at, data, size);
+    }
+}
+
+static void putU8(Writer* w, size_t at, unsigned int value) {
+    unsigned char b = (unsigned char) value;
+    putBytes(w, at, &b, 1);
+}
+
+static void putU16(Writer* w, size_t at, unsigned int value) {
+    unsigned char b[2];
+    b[0] = (unsigned char) value;
+    b[1] = (unsigned char) (value >> 8);
+    putBytes(w, at, b, 2);
+}
+
+static void putU32(Writer* w, size_t at, size_t value) {
+    unsigned char b[4];
+    b[0] = (unsigned char) value;
+    b[1] = (unsigned char) (value >> 8);
+    b[2] = (unsigned char) (value >> 16);
+    b[3] = (unsigned char) (value >> 24);
+    putBytes(w, at, b, 4);
+}
+
+/* appends bytes followed by terminating zero */
+static void appendString(Writer* w, const void* data, size_t size) {
+    static const unsigned char zero = 0;
+    if (size > 0) putBytes(w, w->pos, data, size);
+    putBytes(w, w->pos + size, &zero, 1);
+    w->pos += size + 1;
+}
+
+static void alignTo4(Writer* w) {
+    static const unsigned char zeros[3] = { 0, 0, 0 };
+    size_t padding = (4 - (w->pos & 3)) & 3;
+    putBytes(w, w->pos, zeros, padding);
+    w->pos += padding;
+}
+
+static void writeResult(Writer* w, RecognizerResult* result) {
+    const char* usdlValues[RECOGNIZER_USDL_NUM_FIELDS];
+    const char* const* keys = (const char* const*) &USDLFieldKeys;
+    size_t start = w->pos;
+    size_t numFields = 0;
+    const void* raw = NULL;
+    size_t rawSize = 0;
+    const void* extended = NULL;
+    size_t extendedSize = 0;
+    unsigned int kind;
+    unsigned int barcodeType;
+    unsigned int flags = 0;
+    int isUsdl = 0;
+    int flag = 0;
+    size_t i;
+
+    if (recognizerResultIsUSDLResult(result, &isUsdl) == RECOGNIZER_ERROR_STATUS_SUCCESS && isUsdl) {
+        kind = RECOGNIZER_RESULT_KIND_USDL;
+        barcodeType = BARCODE_TYPE_PDF417;
+        if (recognizerResultGetUSDLRawBinaryData(result, &raw, &rawSize) != RECOGNIZER_ERROR_STATUS_SUCCESS || raw == NULL) rawSize = 0;
+        /* keys are visited in index order, so field table is sorted by field index */
+        for (i = 0; i < RECOGNIZER_USDL_NUM_FIELDS; ++i) {
+            const char* value = NULL;
+            if (keys[i] != NULL && recognizerResultGetUSDLField(result, &value, keys[i]) == RECOGNIZER_ERROR_STATUS_SUCCESS && value != NULL && value[0] != '\0') {
+                usdlValues[i] = value;
+                ++numFields;
+            } else {
+                usdlValues[i] = NULL;
+            }
+        }
+    } else {
+        BarcodeType type;
+        kind = RECOGNIZER_RESULT_KIND_BARCODE;
+        barcodeType = recognizerResultGetBarcodeType(result, &type) == RECOGNIZER_ERROR_STATUS_SUCCESS ? (unsigned int) type : BARCODE_TYPE_NOT_BARCODE;
+        if (recognizerResultGetBarcodeRawData(result, &raw, &rawSize) != RECOGNIZER_ERROR_STATUS_SUCCESS || raw == NULL) rawSize = 0;
+        if (recognizerResultGetBarcodeExtendedRawData(result, &extended, &extendedSize) == RECOGNIZER_ERROR_STATUS_SUCCESS && extended != NULL) {
+            flags |= RECOGNIZER_RESULT_FLAG_EXTENDED;
+        } else {
+            extendedSize = 0;
+        }
+    }
+    if (recognizerResultIsResultUncertain(result, &flag) == RECOGNIZER_ERROR_STATUS_SUCCESS && flag) flags |= RECOGNIZER_RESULT_FLAG_UNCERTAIN;
+    if (recognizerResultIsResultValid(result, &flag) == RECOGNIZER_ERROR_STATUS_SUCCESS && flag) flags |= RECOGNIZER_RESULT_FLAG_VALID;
+
+    putU8(w, start + 4, kind);
+    putU8(w, start + 5, barcodeType);
+    putU8(w, start + 6, flags);
+    putU8(w, start + 7, 0);
+    putU32(w, start + 8, rawSize);
+    putU32(w, start + 12, extendedSize);
+    putU32(w, start + 16, numFields);
+    w->pos = start + RECOGNIZER_RESULT_RECORD_HEADER_SIZE + numFields * RECOGNIZER_RESULT_FIELD_ENTRY_SIZE;
+
+    appendString(w, raw, rawSize);
+    if (flags & RECOGNIZER_RESULT_FLAG_EXTENDED) appendString(w, extended, extendedSize);
+
+    if (numFields > 0) {
+        size_t entry = start + RECOGNIZER_RESULT_RECORD_HEADER_SIZE;
+        for (i = 0; i < RECOGNIZER_USDL_NUM_FIELDS; ++i) {
+            size_t valueSize;
+            if (usdlValues[i] == NULL) continue;
+            valueSize = strlen(usdlValues[i]);
+            putU16(w, entry, (unsigned int) i);
+            putU16(w, entry + 2, 0);
+            putU32(w, entry + 4, w->pos - start);
+            putU32(w, entry + 8, valueSize);
+            entry += RECOGNIZER_RESULT_FIELD_ENTRY_SIZE;
+            appendString(w, usdlValues[i], valueSize);
+        }
+    }
+
+    alignTo4(w);
+    putU32(w, start, w->pos - start);
+}
+
+RecognizerErrorStatus recognizerResultListSerialize(const RecognizerResultList* resultList, void* buffer, size_t capacity, size_t* needed) {
+    Writer w;
+    size_t numResults = 0;
+    size_t i;
+
+    if (needed == NULL) return RECOGNIZER_ERROR_STATUS_POINTER_IS_NULL;
+
+    w.buffer = (unsigned char*) buffer;
+    w.capacity = buffer != NULL ? capacity : 0;
+
+    if (resultList != NULL) recognizerResultListGetNumOfResults(resultList, &numResults);
+
+    w.pos = RECOGNIZER_RESULT_LIST_HEADER_SIZE + numResults * 4;
+    for (i = 0; i < numResults; ++i) {
+        RecognizerResult* result;
+        putU32(&w, RECOGNIZER_RESULT_LIST_HEADER_SIZE + i * 4, w.pos);
+        if (recognizerResultListGetResultAtIndex(resultList, i, &result) != RECOGNIZER_ERROR_STATUS_SUCCESS) return RECOGNIZER_ERROR_STATUS_FAIL;
+        writeResult(&w, result);
+    }
+
+    putU32(&w, 0, RECOGNIZER_RESULT_LIST_MAGIC);
+    putU16(&w, 4, RECOGNIZER_RESULT_LIST_FORMAT_VERSION);
+    putU16(&w, 6, RECOGNIZER_RESULT_LIST_HEADER_SIZE);
+    putU32(&w, 8, w.pos);
+    putU32(&w, 12, numResults);
+    putU32(&w, 16, 0);
+
+    *needed = w.pos;
+    return w.pos <= w.capacity ? RECOGNIZER_ERROR_STATUS_SUCCESS : RECOGNIZER_ERROR_STATUS_FAIL;
+}
@@ -0,0 +1,129 @@
+/*
+ * RecognizerResultView.c
+ *
+ * Reading side of result list serialization, see RecognizerResultSerialization.h.
+ * Does not call into RecognizerApi library, so it can be used by processes that only receive results.
+ */
+
+#include <string.h>
+
+#include "RecognizerResultSerialization.h"
+
+static size_t getU16(const unsigned char* p) {
+    return (size_t) p[0] | ((size_t) p[1] << 8);
+}
+
+static size_t getU32(const unsigned char* p) {
+    return (size_t) p[0] | ((size_t) p[1] << 8) | ((size_t) p[2] << 16) | ((size_t) p[3] << 24);
+}
+
+RecognizerErrorStatus recognizerResultListDeserialize(const void* buffer, size_t size, RecognizerResultListView* view) {
+    const unsigned char* data = (const unsigned char*) buffer;
+    size_t headerSize;
+    size_t totalSize;
+    size_t numResults;
+
+    if (buffer == NULL || view == NULL) return RECOGNIZER_ERROR_STATUS_POINTER_IS_NULL;
+    memset(view, 0, sizeof(*view));
+
+    if (size < RECOGNIZER_RESULT_LIST_HEADER_SIZE || getU32(data) != RECOGNIZER_RESULT_LIST_MAGIC) return RECOGNIZER_ERROR_STATUS_INVALID_TYPE;
+    if (getU16(data + 4) != RECOGNIZER_RESULT_LIST_FORMAT_VERSION) return RECOGNIZER_ERROR_STATUS_INVALID_TYPE;
+
+    headerSize = getU16(data + 6);
+    totalSize = getU32(data + 8);
+    numResults = getU32(data + 12);
+    if (headerSize < RECOGNIZER_RESULT_LIST_HEADER_SIZE || totalSize > size || headerSize > totalSize) return RECOGNIZER_ERROR_STATUS_INVALID_TYPE;
+    if (numResults > (totalSize - headerSize) / 4) return RECOGNIZER_ERROR_STATUS_INVALID_TYPE;
+
+    view->data = data;
+    view->size = totalSize;
+    view->offsetsStart = headerSize;
+    view->numResults = numResults;
+    return RECOGNIZER_ERROR_STATUS_SUCCESS;
+}
+
+/* checks that [offset, offset + length] lies inside record and that record[offset + length] is zero */
+static int isTerminatedString(const unsigned char* record, size_t recordSize, size_t offset, size_t length) {
+    return offset <= recordSize && length < recordSize - offset && record[offset + length] == 0;
+}
+
+RecognizerErrorStatus recognizerResultListViewGetResultAtIndex(const RecognizerResultListView* view, size_t index, RecognizerResultView* result) {
+    const unsigned char* record;
+    size_t offset, recordSize, flags, dataOffset, fieldsEnd, i;
+
+    if (view == NULL || result == NULL) return RECOGNIZER_ERROR_STATUS_POINTER_IS_NULL;
+    memset(result, 0, sizeof(*result));
+    if (index >= view->numResults) return RECOGNIZER_ERROR_STATUS_INDEX_OUT_OF_RANGE;
+
+    offset = getU32(view->data + view->offsetsStart + index * 4);
+    if (offset > view->size || view->size - offset < RECOGNIZER_RESULT_RECORD_HEADER_SIZE) return RECOGNIZER_ERROR_STATUS_INVALID_TYPE;
+    record = view->data + offset;
+    recordSize = getU32(record);
+    if (recordSize < RECOGNIZER_RESULT_RECORD_HEADER_SIZE || recordSize > view->size - offset) return RECOGNIZER_ERROR_STATUS_INVALID_TYPE;
+
+    flags = record[6];
+    result->isUsdl = record[4] == RECOGNIZER_RESULT_KIND_USDL;
+    result->barcodeType = (BarcodeType) record[5];
+    result->uncertain = (flags & RECOGNIZER_RESULT_FLAG_UNCERTAIN) != 0;
+    result->valid = (flags & RECOGNIZER_RESULT_FLAG_VALID) != 0;
+    result->rawDataSize = getU32(record + 8);
+    result->numUsdlFields = getU32(record + 16);
+    result->record = record;
+
+    if (result->numUsdlFields > (recordSize - RECOGNIZER_RESULT_RECORD_HEADER_SIZE) / RECOGNIZER_RESULT_FIELD_ENTRY_SIZE) return RECOGNIZER_ERROR_STATUS_INVALID_TYPE;
+    fieldsEnd = RECOGNIZER_RESULT_RECORD_HEADER_SIZE + result->numUsdlFields * RECOGNIZER_RESULT_FIELD_ENTRY_SIZE;
+
+    dataOffset = fieldsEnd;
+    if (!isTerminatedString(record, recordSize, dataOffset, result->rawDataSize)) return RECOGNIZER_ERROR_STATUS_INVALID_TYPE;
+    result->rawData = (const char*) record + dataOffset;
+    dataOffset += result->rawDataSize + 1;
+
+    if (flags & RECOGNIZER_RESULT_FLAG_EXTENDED) {
+        result->extendedDataSize = getU32(record + 12);
+        if (!isTerminatedString(record, recordSize, dataOffset, result->extendedDataSize)) return RECOGNIZER_ERROR_STATUS_INVALID_TYPE;
+        result->extendedData = (const char*) record + dataOffset;
+    }
+
+    /* validating field table here keeps field accessors free of bounds checks */
+    for (i = 0; i < result->numUsdlFields; ++i) {
+        const unsigned char* entry = record + RECOGNIZER_RESULT_RECORD_HEADER_SIZE + i * RECOGNIZER_RESULT_FIELD_ENTRY_SIZE;
+        size_t valueOffset = getU32(entry + 4);
+        if (valueOffset < fieldsEnd || !isTerminatedString(record, recordSize, valueOffset, getU32(entry + 8))) return RECOGNIZER_ERROR_STATUS_INVALID_TYPE;
+        if (i > 0 && getU16(entry) <= getU16(entry - RECOGNIZER_RESULT_FIELD_ENTRY_SIZE)) return RECOGNIZER_ERROR_STATUS_INVALID_TYPE;
+    }
+    return RECOGNIZER_ERROR_STATUS_SUCCESS;
+}
+
+RecognizerErrorStatus recognizerResultViewGetUSDLFieldAt(const RecognizerResultView* result, size_t i, size_t* fieldIndex, const char** value, size_t* valueSize) {
+    const unsigned char* entry;
+    if (result == NULL || result->record == NULL) return RECOGNIZER_ERROR_STATUS_POINTER_IS_NULL;
+    if (i >= result->numUsdlFields) return RECOGNIZER_ERROR_STATUS_INDEX_OUT_OF_RANGE;
+    entry = result->record + RECOGNIZER_RESULT_RECORD_HEADER_SIZE + i * RECOGNIZER_RESULT_FIELD_ENTRY_SIZE;
+    if (fieldIndex != NULL) *fieldIndex = getU16(entry);
+    if (value != NULL) *value = (const char*) result->record + getU32(entry + 4);
+    if (valueSize != NULL) *valueSize = getU32(entry + 8);
+    return RECOGNIZER_ERROR_STATUS_SUCCESS;
+}
+
+RecognizerErrorStatus recognizerResultViewGetUSDLField(const RecognizerResultView* result, size_t fieldIndex, const char** value) {
+    size_t lo = 0;
+    size_t hi;
+
+    if (result == NULL || value == NULL) return RECOGNIZER_ERROR_STATUS_POINTER_IS_NULL;
+    *value = NULL;
+    if (!result->isUsdl) return RECOGNIZER_ERROR_STATUS_INVALID_TYPE;
+
+    /* field table is sorted by field index */
+    hi = result->numUsdlFields;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const unsigned char* entry = result->record + RECOGNIZER_RESULT_RECORD_HEADER_SIZE + mid * RECOGNIZER_RESULT_FIELD_ENTRY_SIZE;
+        size_t current = getU16(entry);
+        if (current == fieldIndex) {
+            *value = (const char*) result->record + getU32(entry + 4);
+            return RECOGNIZER_ERROR_STATUS_SUCCESS;
+        }
+        if (current < fieldIndex) lo = mid + 1; else hi = mid;
+    }
+    return RECOGNIZER_ERROR_STATUS_UNKNOWN_KEY;
+}
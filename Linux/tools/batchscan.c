@@ -0,0 +1,685 @@
+/*
+ * batchscan.c
+ *
+ * Batch scanner for large image collections. All recognizers are created once at
+ * startup and shared by a fixed number of worker threads, so neither process startup
+ * nor recognizerCreate is paid per image. Every scanned file produces exactly one JSON
+ * line in the output, written and flushed as soon as the file is done.
+ *
+ * Inputs may be image files, directories (scanned recursively for supported image
+ * extensions), quoted glob patterns or lists of paths read from a file or stdin.
+ * When output goes to a file, the scan can be resumed after a crash or interruption
+ * with -r: paths already present in the output are skipped and a trailing partially
+ * written line is discarded.
+ */
+
+#define _XOPEN_SOURCE 700
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <glob.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#include "RecognizerApi.h"
+#include "RecognizerResultJson.h"
+
+#define BATCH_MAX_WORKERS 256
+
+/* set from SIGINT/SIGTERM handler; workers finish their current file and stop */
+static volatile sig_atomic_t stopRequested_ = 0;
+
+static void onStopSignal(int signo) {
+    (void) signo;
+    stopRequested_ = 1;
+}
+
+static double nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+/*==============================================================*/
+/*======================= PATH LIST ============================*/
+/*==============================================================*/
+
+typedef struct PathList {
+    char** items;
+    size_t size;
+    size_t capacity;
+} PathList;
+
+static int pathListAdd(PathList* list, const char* path) {
+    char* copy;
+    if (list->size == list->capacity) {
+        size_t newCapacity = list->capacity ? list->capacity * 2 : 256;
+        char** items = (char**) realloc(list->items, newCapacity * sizeof(char*));
+        if (items == NULL) return 0;
+        list->items = items;
+        list->capacity = newCapacity;
+    }
+    copy = strdup(path);
+    if (copy == NULL) return 0;
+    list->items[list->size++] = copy;
+    return 1;
+}
+
+static void pathListFree(PathList* list) {
+    size_t i;
+    for (i = 0; i < list->size; ++i) {
+        free(list->items[i]);
+    }
+    free(list->items);
+    list->items = NULL;
+    list->size = list->capacity = 0;
+}
+
+static int comparePaths(const void* a, const void* b) {
+    return strcmp(*(char* const*) a, *(char* const*) b);
+}
+
+/*==============================================================*/
+/*======================== PATH SET ============================*/
+/*==============================================================*/
+
+/* open addressing hash set of paths already present in the output (used by resume) */
+typedef struct PathSet {
+    char** slots;
+    size_t capacity;
+    size_t size;
+} PathSet;
+
+static size_t hashPath(const char* s) {
+    /* FNV-1a */
+    size_t h = (size_t) 2166136261u;
+    while (*s) {
+        h ^= (unsigned char) *s++;
+        h *= (size_t) 16777619u;
+    }
+    return h;
+}
+
+static int pathSetContains(const PathSet* set, const char* path) {
+    size_t i;
+    if (set->capacity == 0) return 0;
+    i = hashPath(path) & (set->capacity - 1);
+    while (set->slots[i] != NULL) {
+        if (strcmp(set->slots[i], path) == 0) return 1;
+        i = (i + 1) & (set->capacity - 1);
+    }
+    return 0;
+}
+
+static int pathSetInsertOwned(PathSet* set, char* path);
+
+static int pathSetGrow(PathSet* set) {
+    PathSet bigger;
+    size_t i;
+    bigger.capacity = set->capacity ? set->capacity * 2 : 1024;
+    bigger.size = 0;
+    bigger.slots = (char**) calloc(bigger.capacity, sizeof(char*));
+    if (bigger.slots == NULL) return 0;
+    for (i = 0; i < set->capacity; ++i) {
+        if (set->slots[i] != NULL) pathSetInsertOwned(&bigger, set->slots[i]);
+    }
+    free(set->slots);
+    *set = bigger;
+    return 1;
+}
+
+/* takes ownership of path */
+static int pathSetInsertOwned(PathSet* set, char* path) {
+    size_t i;
+    if ((set->size + 1) * 2 > set->capacity && !pathSetGrow(set)) {
+        free(path);
+        return 0;
+    }
+    i = hashPath(path) & (set->capacity - 1);
+    while (set->slots[i] != NULL) {
+        if (strcmp(set->slots[i], path) == 0) {
+            free(path);
+            return 1;
+        }
+        i = (i + 1) & (set->capacity - 1);
+    }
+    set->slots[i] = path;
+    set->size++;
+    return 1;
+}
+
+static void pathSetFree(PathSet* set) {
+    size_t i;
+    for (i = 0; i < set->capacity; ++i) {
+        free(set->slots[i]);
+    }
+    free(set->slots);
+    set->slots = NULL;
+    set->capacity = set->size = 0;
+}
+
+/*==============================================================*/
+/*===================== STRING BUFFER ==========================*/
+/*==============================================================*/
+
+typedef struct StrBuf {
+    char* data;
+    size_t size;
+    size_t capacity;
+} StrBuf;
+
+static int strBufReserve(StrBuf* sb, size_t extra) {
+    if (sb->size + extra + 1 > sb->capacity) {
+        size_t newCapacity = sb->capacity ? sb->capacity : 4096;
+        char* data;
+        while (sb->size + extra + 1 > newCapacity) newCapacity *= 2;
+        data = (char*) realloc(sb->data, newCapacity);
+        if (data == NULL) return 0;
+        sb->data = data;
+        sb->capacity = newCapacity;
+    }
+    return 1;
+}
+
+static void strBufAppend(StrBuf* sb, const char* s, size_t len) {
+    if (!strBufReserve(sb, len)) return;
+    memcpy(sb->data + sb->size, s, len);
+    sb->size += len;
+    sb->data[sb->size] = '\0';
+}
+
+static void strBufAppendStr(StrBuf* sb, const char* s) {
+    strBufAppend(sb, s, strlen(s));
+}
+
+static void strBufPrintf(StrBuf* sb, const char* format, ...) {
+    char tmp[128];
+    int len;
+    va_list args;
+    va_start(args, format);
+    len = vsnprintf(tmp, sizeof(tmp), format, args);
+    va_end(args);
+    if (len > 0) strBufAppend(sb, tmp, (size_t) len < sizeof(tmp) ? (size_t) len : sizeof(tmp) - 1);
+}
+
+/* appends data as a quoted JSON string, escaped by recognizerJsonWriteString */
+static void strBufAppendJsonString(StrBuf* sb, const char* data, size_t len) {
+    size_t needed = 0;
+    if (!strBufReserve(sb, len + 2)) return;
+    /* retried only when data needs escaping beyond the initial guess */
+    if (recognizerJsonWriteString(data, len, sb->data + sb->size, sb->capacity - sb->size - 1, &needed) != RECOGNIZER_ERROR_STATUS_SUCCESS) {
+        if (!strBufReserve(sb, needed)) return;
+        recognizerJsonWriteString(data, len, sb->data + sb->size, sb->capacity - sb->size - 1, &needed);
+    }
+    sb->size += needed;
+    sb->data[sb->size] = '\0';
+}
+
+/* appends result list as JSON array written by recognizerResultListToJson */
+static void strBufAppendResultsJson(StrBuf* sb, const RecognizerResultList* resultList) {
+    size_t needed = 0;
+    if (!strBufReserve(sb, 2)) return;
+    /* line buffer is reused between files, so it usually already has room */
+    if (recognizerResultListToJson(resultList, sb->data + sb->size, sb->capacity - sb->size, &needed) != RECOGNIZER_ERROR_STATUS_SUCCESS) {
+        if (!strBufReserve(sb, needed) || recognizerResultListToJson(resultList, sb->data + sb->size, sb->capacity - sb->size, &needed) != RECOGNIZER_ERROR_STATUS_SUCCESS) return;
+    }
+    /* needed includes terminating zero, which is already in place */
+    sb->size += needed - 1;
+}
+
+/*==============================================================*/
+/*===================== INPUT COLLECTION =======================*/
+/*==============================================================*/
+
+/* extensions of encodings supported by recognizerRecognizeFromFile */
+static int hasImageExtension(const char* path) {
+    static const char* extensions[] = { "bmp", "dib", "jpeg", "jpg", "jpe", "jp2", "png", "tiff", "tif" };
+    const char* dot = strrchr(path, '.');
+    size_t i;
+    if (dot == NULL || strchr(dot, '/') != NULL) return 0;
+    ++dot;
+    for (i = 0; i < sizeof(extensions) / sizeof(extensions[0]); ++i) {
+        const char* a = dot;
+        const char* b = extensions[i];
+        while (*a && *b && tolower((unsigned char) *a) == *b) { ++a; ++b; }
+        if (*a == '\0' && *b == '\0') return 1;
+    }
+    return 0;
+}
+
+static int walkDirectory(PathList* paths, const char* dir) {
+    DIR* d = opendir(dir);
+    struct dirent* entry;
+    StrBuf child = { NULL, 0, 0 };
+    if (d == NULL) {
+        fprintf(stderr, "Cannot open directory %s: %s\n", dir, strerror(errno));
+        return 0;
+    }
+    while ((entry = readdir(d)) != NULL) {
+        struct stat st;
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+        child.size = 0;
+        strBufAppendStr(&child, dir);
+        if (child.size > 0 && child.data[child.size - 1] != '/') strBufAppend(&child, "/", 1);
+        strBufAppendStr(&child, entry->d_name);
+        if (lstat(child.data, &st) != 0) continue;
+        if (S_ISDIR(st.st_mode)) {
+            /* symlinked directories are not followed to avoid cycles */
+            walkDirectory(paths, child.data);
+        } else if (hasImageExtension(child.data)) {
+            if (S_ISLNK(st.st_mode) && (stat(child.data, &st) != 0 || !S_ISREG(st.st_mode))) continue;
+            pathListAdd(paths, child.data);
+        }
+    }
+    closedir(d);
+    free(child.data);
+    return 1;
+}
+
+/* adds a single input: file, directory or glob pattern */
+static void collectInput(PathList* paths, const char* input) {
+    struct stat st;
+    if (stat(input, &st) == 0) {
+        if (S_ISDIR(st.st_mode)) {
+            walkDirectory(paths, input);
+        } else {
+            pathListAdd(paths, input);
+        }
+    } else if (strpbrk(input, "*?[") != NULL) {
+        glob_t g;
+        if (glob(input, 0, NULL, &g) == 0) {
+            size_t i;
+            for (i = 0; i < g.gl_pathc; ++i) {
+                collectInput(paths, g.gl_pathv[i]);
+            }
+        } else {
+            fprintf(stderr, "Pattern %s matched nothing\n", input);
+        }
+        globfree(&g);
+    } else {
+        /* keep it so that the failure is reported in output */
+        pathListAdd(paths, input);
+    }
+}
+
+/* reads newline or NUL separated inputs from list file ("-" for stdin) */
+static int collectFromList(PathList* paths, const char* listPath, int delimiter) {
+    FILE* fp = strcmp(listPath, "-") == 0 ? stdin : fopen(listPath, "r");
+    char* line = NULL;
+    size_t lineCapacity = 0;
+    ssize_t len;
+    if (fp == NULL) {
+        fprintf(stderr, "Cannot open list %s: %s\n", listPath, strerror(errno));
+        return 0;
+    }
+    while ((len = getdelim(&line, &lineCapacity, delimiter, fp)) != -1) {
+        if (len > 0 && line[len - 1] == (char) delimiter) line[--len] = '\0';
+        if (delimiter == '\n' && len > 0 && line[len - 1] == '\r') line[--len] = '\0';
+        if (len > 0) collectInput(paths, line);
+    }
+    free(line);
+    if (fp != stdin) fclose(fp);
+    return 1;
+}
+
+/*==============================================================*/
+/*========================= RESUME =============================*/
+/*==============================================================*/
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+/*
+ * Decodes the "path" value at the beginning of an output line. Inverse of
+ * strBufAppendJsonString: \u0080-\u00ff escapes are only produced for bytes that were not
+ * valid UTF-8, so they are decoded back to those raw bytes.
+ */
+static char* parseOutputPath(const char* line) {
+    static const char prefix[] = "{\"path\":\"";
+    const char* s;
+    StrBuf out = { NULL, 0, 0 };
+    if (strncmp(line, prefix, sizeof(prefix) - 1) != 0) return NULL;
+    s = line + sizeof(prefix) - 1;
+    while (*s && *s != '"') {
+        char c = *s++;
+        if (c == '\\') {
+            c = *s++;
+            switch (c) {
+                case 'n': c = '\n'; break;
+                case 'r': c = '\r'; break;
+                case 't': c = '\t'; break;
+                case 'u': {
+                    int h0, h1, h2, h3;
+                    if ((h0 = hexValue(s[0])) < 0 || (h1 = hexValue(s[1])) < 0 ||
+                        (h2 = hexValue(s[2])) < 0 || (h3 = hexValue(s[3])) < 0 || h0 != 0 || h1 != 0) {
+                        free(out.data);
+                        return NULL;
+                    }
+                    c = (char) (h2 * 16 + h3);
+                    s += 4;
+                    break;
+                }
+                case '"': case '\\': break;
+                default:
+                    free(out.data);
+                    return NULL;
+            }
+        }
+        strBufAppend(&out, &c, 1);
+    }
+    if (*s != '"') {
+        free(out.data);
+        return NULL;
+    }
+    if (out.data == NULL) strBufAppend(&out, "", 0);
+    return out.data;
+}
+
+/*
+ * Loads paths already present in the output file and truncates a trailing incomplete
+ * line left by a crash, so that appended lines stay well-formed.
+ */
+static int loadResumeState(const char* outputPath, PathSet* done) {
+    FILE* fp = fopen(outputPath, "r");
+    char* line = NULL;
+    size_t lineCapacity = 0;
+    ssize_t len;
+    off_t completeBytes = 0;
+    off_t totalBytes = 0;
+    if (fp == NULL) {
+        /* nothing to resume */
+        return errno == ENOENT;
+    }
+    while ((len = getline(&line, &lineCapacity, fp)) != -1) {
+        totalBytes += len;
+        if (line[len - 1] != '\n') break;
+        completeBytes = totalBytes;
+        {
+            char* path = parseOutputPath(line);
+            if (path != NULL && !pathSetInsertOwned(done, path)) {
+                free(line);
+                fclose(fp);
+                return 0;
+            }
+        }
+    }
+    free(line);
+    fclose(fp);
+    if (totalBytes != completeBytes) {
+        fprintf(stderr, "Discarding incomplete last line of %s\n", outputPath);
+        if (truncate(outputPath, completeBytes) != 0) {
+            fprintf(stderr, "Cannot truncate %s: %s\n", outputPath, strerror(errno));
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*==============================================================*/
+/*========================= SCANNING ===========================*/
+/*==============================================================*/
+
+typedef struct BatchContext {
+    PathList paths;
+    size_t next;
+    FILE* out;
+    pthread_mutex_t lock;
+
+    size_t numScanned;
+    size_t numFailed;
+    size_t numResults;
+} BatchContext;
+
+typedef struct Worker {
+    BatchContext* ctx;
+    Recognizer* recognizer;
+    StrBuf line;
+    pthread_t thread;
+} Worker;
+
+static void* workerMain(void* arg) {
+    Worker* w = (Worker*) arg;
+    BatchContext* ctx = w->ctx;
+
+    for (;;) {
+        const char* path;
+        RecognizerResultList* resultList = NULL;
+        RecognizerErrorStatus status;
+        size_t numResults = 0;
+        double start, elapsed;
+
+        pthread_mutex_lock(&ctx->lock);
+        if (stopRequested_ || ctx->next >= ctx->paths.size) {
+            pthread_mutex_unlock(&ctx->lock);
+            break;
+        }
+        path = ctx->paths.items[ctx->next++];
+        pthread_mutex_unlock(&ctx->lock);
+
+        start = nowMs();
+        status = recognizerRecognizeFromFile(w->recognizer, &resultList, path, NULL);
+        elapsed = nowMs() - start;
+
+        w->line.size = 0;
+        strBufAppendStr(&w->line, "{\"path\":");
+        strBufAppendJsonString(&w->line, path, strlen(path));
+        if (status == RECOGNIZER_ERROR_STATUS_SUCCESS) {
+            recognizerResultListGetNumOfResults(resultList, &numResults);
+            strBufPrintf(&w->line, ",\"status\":\"ok\",\"ms\":%.3f,\"results\":", elapsed);
+            strBufAppendResultsJson(&w->line, resultList);
+            strBufAppendStr(&w->line, "}\n");
+        } else {
+            const char* err = recognizerErrorToString(status);
+            strBufPrintf(&w->line, ",\"status\":\"error\",\"ms\":%.3f,\"error\":", elapsed);
+            strBufAppendJsonString(&w->line, err, strlen(err));
+            strBufAppendStr(&w->line, "}\n");
+        }
+        recognizerResultListDelete(&resultList);
+
+        pthread_mutex_lock(&ctx->lock);
+        /* one write and flush per line keeps the output resumable after a crash */
+        fwrite(w->line.data, 1, w->line.size, ctx->out);
+        fflush(ctx->out);
+        ctx->numScanned++;
+        ctx->numResults += numResults;
+        if (status != RECOGNIZER_ERROR_STATUS_SUCCESS) ctx->numFailed++;
+        pthread_mutex_unlock(&ctx->lock);
+    }
+    return NULL;
+}
+
+static Recognizer* createRecognizer(const char* licensee, const char* licenseKey, unsigned int threadsPerRecognizer) {
+    RecognizerSettings* settings;
+    RecognizerDeviceInfo* deviceInfo;
+    Recognizer* recognizer = NULL;
+    RecognizerErrorStatus status;
+
+    recognizerSettingsCreate(&settings);
+    recognizerDeviceInfoCreate(&deviceInfo);
+    recognizerDeviceInfoSetNumberOfProcessors(deviceInfo, threadsPerRecognizer);
+    recognizerSettingsSetDeviceInfo(settings, deviceInfo);
+
+    {
+        Pdf417Settings pdf417Sett;
+        memset(&pdf417Sett, 0, sizeof(pdf417Sett));
+        pdf417Sett.useAutoScale = 1;
+        pdf417Sett.shouldScanUncertain = 1;
+        recognizerSettingsSetPdf417Settings(settings, &pdf417Sett);
+    }
+    {
+        ZXingSettings zxingSett;
+        memset(&zxingSett, 0, sizeof(zxingSett));
+        zxingSett.scanQRCode = 1;
+        recognizerSettingsSetZXingSettings(settings, &zxingSett);
+    }
+    {
+        UsdlSettings usdlSett;
+        memset(&usdlSett, 0, sizeof(usdlSett));
+        usdlSett.useAutoScale = 1;
+        recognizerSettingsSetUsdlSettings(settings, &usdlSett);
+    }
+
+    recognizerSettingsSetLicenseKey(settings, licensee, licenseKey);
+
+    status = recognizerCreate(&recognizer, settings);
+    if (status != RECOGNIZER_ERROR_STATUS_SUCCESS) {
+        fprintf(stderr, "Error creating recognizer: %s\n", recognizerErrorToString(status));
+        recognizer = NULL;
+    }
+
+    recognizerDeviceInfoDelete(&deviceInfo);
+    recognizerSettingsDelete(&settings);
+    return recognizer;
+}
+
+static void printUsage(const char* program) {
+    fprintf(stderr,
+        "usage: %s [options] [file|directory|'glob'] ...\n"
+        "  -j N         number of worker threads, each with its own recognizer (default: number of CPUs)\n"
+        "  -p N         processors given to each recognizer (default 1)\n"
+        "  -f LIST      read inputs from LIST, one per line (\"-\" for stdin)\n"
+        "  -0           inputs in LIST are NUL separated (e.g. find -print0)\n"
+        "  -o FILE      append JSON lines to FILE instead of stdout\n"
+        "  -r           resume: skip paths already present in FILE given with -o\n"
+        "  -L LICENSEE  licensee (default: $RECOGNIZER_LICENSEE)\n"
+        "  -K KEY       license key (default: $RECOGNIZER_LICENSE_KEY)\n",
+        program);
+}
+
+int main(int argc, char* argv[]) {
+    BatchContext ctx;
+    PathSet done = { NULL, 0, 0 };
+    Worker* workers;
+    const char* outputPath = NULL;
+    const char* listPath = NULL;
+    const char* licensee = getenv("RECOGNIZER_LICENSEE");
+    const char* licenseKey = getenv("RECOGNIZER_LICENSE_KEY");
+    long numWorkers = sysconf(_SC_NPROCESSORS_ONLN);
+    long threadsPerRecognizer = 1;
+    int delimiter = '\n';
+    int resume = 0;
+    int opt;
+    size_t numSkipped = 0;
+    size_t i, kept;
+    double start;
+    struct sigaction sa;
+
+    while ((opt = getopt(argc, argv, "j:p:f:0o:rL:K:h")) != -1) {
+        switch (opt) {
+            case 'j': numWorkers = strtol(optarg, NULL, 10); break;
+            case 'p': threadsPerRecognizer = strtol(optarg, NULL, 10); break;
+            case 'f': listPath = optarg; break;
+            case '0': delimiter = '\0'; break;
+            case 'o': outputPath = optarg; break;
+            case 'r': resume = 1; break;
+            case 'L': licensee = optarg; break;
+            case 'K': licenseKey = optarg; break;
+            default:
+                printUsage(argv[0]);
+                return 2;
+        }
+    }
+    if (numWorkers < 1) numWorkers = 1;
+    if (numWorkers > BATCH_MAX_WORKERS) numWorkers = BATCH_MAX_WORKERS;
+    if (threadsPerRecognizer < 1) threadsPerRecognizer = 1;
+    if ((optind >= argc && listPath == NULL) || (resume && outputPath == NULL)) {
+        printUsage(argv[0]);
+        return 2;
+    }
+    if (licensee == NULL || licenseKey == NULL) {
+        fprintf(stderr, "License is not set, use -L and -K or RECOGNIZER_LICENSEE and RECOGNIZER_LICENSE_KEY\n");
+        return 2;
+    }
+
+    memset(&ctx, 0, sizeof(ctx));
+    pthread_mutex_init(&ctx.lock, NULL);
+
+    for (i = (size_t) optind; i < (size_t) argc; ++i) {
+        collectInput(&ctx.paths, argv[i]);
+    }
+    if (listPath != NULL && !collectFromList(&ctx.paths, listPath, delimiter)) return 2;
+
+    /* sorted order makes runs reproducible and lets duplicate inputs be dropped */
+    qsort(ctx.paths.items, ctx.paths.size, sizeof(char*), comparePaths);
+
+    if (resume && !loadResumeState(outputPath, &done)) return 2;
+
+    kept = 0;
+    for (i = 0; i < ctx.paths.size; ++i) {
+        int duplicate = kept > 0 && strcmp(ctx.paths.items[kept - 1], ctx.paths.items[i]) == 0;
+        if (duplicate || pathSetContains(&done, ctx.paths.items[i])) {
+            if (!duplicate) ++numSkipped;
+            free(ctx.paths.items[i]);
+        } else {
+            ctx.paths.items[kept++] = ctx.paths.items[i];
+        }
+    }
+    ctx.paths.size = kept;
+    pathSetFree(&done);
+
+    if (outputPath != NULL) {
+        ctx.out = fopen(outputPath, "a");
+        if (ctx.out == NULL) {
+            fprintf(stderr, "Cannot open %s: %s\n", outputPath, strerror(errno));
+            return 2;
+        }
+    } else {
+        ctx.out = stdout;
+    }
+
+    if ((size_t) numWorkers > ctx.paths.size) numWorkers = ctx.paths.size > 0 ? (long) ctx.paths.size : 1;
+    workers = (Worker*) calloc((size_t) numWorkers, sizeof(Worker));
+    if (workers == NULL) return 2;
+    for (i = 0; i < (size_t) numWorkers; ++i) {
+        workers[i].ctx = &ctx;
+        workers[i].recognizer = createRecognizer(licensee, licenseKey, (unsigned int) threadsPerRecognizer);
+        if (workers[i].recognizer == NULL) return 2;
+    }
+
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onStopSignal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+
+    start = nowMs();
+    for (i = 0; i < (size_t) numWorkers; ++i) {
+        pthread_create(&workers[i].thread, NULL, workerMain, &workers[i]);
+    }
+    for (i = 0; i < (size_t) numWorkers; ++i) {
+        pthread_join(workers[i].thread, NULL);
+        recognizerDelete(&workers[i].recognizer);
+        free(workers[i].line.data);
+    }
+
+    {
+        double seconds = (nowMs() - start) / 1000.0;
+        fprintf(stderr, "Scanned %lu files (%lu failed, %lu skipped) with %lu results in %.3f s (%.1f files/s)\n",
+            (unsigned long) ctx.numScanned, (unsigned long) ctx.numFailed, (unsigned long) numSkipped,
+            (unsigned long) ctx.numResults, seconds, seconds > 0 ? ctx.numScanned / seconds : 0.0);
+        if (stopRequested_ && ctx.numScanned < ctx.paths.size) {
+            fprintf(stderr, "Interrupted, %lu files left. Run again with -r to continue.\n",
+                (unsigned long) (ctx.paths.size - ctx.numScanned));
+        }
+    }
+
+    if (ctx.out != stdout) fclose(ctx.out);
+    free(workers);
+    pathListFree(&ctx.paths);
+    pthread_mutex_destroy(&ctx.lock);
+
+    return ctx.numFailed > 0 || stopRequested_ ? 1 : 0;
+}
@@ -0,0 +1,201 @@
+/*
+ * loadtest.c
+ *
+ * Load test for recognizerd. Starts a number of client threads, each with its own connection,
+ * which repeatedly send the same image to the daemon and measure request latency.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "RecognizerClient.h"
+#include "RecognizerDaemonProtocol.h"
+
+static double nowMs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+typedef struct LoadTest {
+    const char* socketPath;
+    const char* image;
+    size_t imageSize;
+    size_t requestsPerClient;
+    double deadline;
+    int useInline;
+} LoadTest;
+
+typedef struct Client {
+    const LoadTest* test;
+    pthread_t thread;
+    double* latencies;
+    size_t numRequests;
+    size_t numFailed;
+    size_t numResults;
+    int error;
+} Client;
+
+static void* clientMain(void* arg) {
+    Client* c = (Client*) arg;
+    const LoadTest* test = c->test;
+    RecognizerClient* client = NULL;
+    RecognizerClientFrame* frame = NULL;
+
+    c->error = recognizerClientConnect(&client, test->socketPath);
+    if (c->error != 0) return NULL;
+    if (!test->useInline) {
+        c->error = recognizerClientFrameCreate(&frame, test->imageSize);
+        if (c->error != 0) {
+            recognizerClientDelete(&client);
+            return NULL;
+        }
+        memcpy(recognizerClientFrameGetData(frame), test->image, test->imageSize);
+    }
+
+    while (c->numRequests < test->requestsPerClient && (test->deadline == 0 || nowMs() < test->deadline)) {
+        RecognizerErrorStatus status;
+        double start = nowMs();
+        if (test->useInline) {
+            c->error = recognizerClientRecognizeEncodedImage(client, test->image, test->imageSize, &status);
+        } else {
+            c->error = recognizerClientRecognizeEncodedFrame(client, frame, test->imageSize, &status);
+        }
+        if (c->error != 0) break;
+        c->latencies[c->numRequests++] = nowMs() - start;
+        if (status != RECOGNIZER_ERROR_STATUS_SUCCESS) {
+            c->numFailed++;
+        } else {
+            c->numResults += recognizerClientGetNumOfResults(client);
+        }
+    }
+
+    recognizerClientFrameDelete(&frame);
+    recognizerClientDelete(&client);
+    return NULL;
+}
+
+static int compareDoubles(const void* a, const void* b) {
+    double x = *(const double*) a;
+    double y = *(const double*) b;
+    return x < y ? -1 : x > y;
+}
+
+static char* loadFile(const char* path, size_t* size) {
+    FILE* fp = fopen(path, "rb");
+    char* data;
+    long len;
+    if (fp == NULL) return NULL;
+    if (fseek(fp, 0, SEEK_END) != 0 || (len = ftell(fp)) <= 0 || fseek(fp, 0, SEEK_SET) != 0) {
+        fclose(fp);
+        return NULL;
+    }
+    data = (char*) malloc((size_t) len);
+    if (data != NULL && fread(data, 1, (size_t) len, fp) != (size_t) len) {
+        free(data);
+        data = NULL;
+    }
+    fclose(fp);
+    *size = (size_t) len;
+    return data;
+}
+
+static void printUsage(const char* program) {
+    fprintf(stderr,
+        "usage: %s [options] <image>\n"
+        "  -s PATH  daemon socket path (default " RECOGNIZERD_DEFAULT_SOCKET ")\n"
+        "  -c N     number of concurrent clients (default 4)\n"
+        "  -n N     requests per client (default 100)\n"
+        "  -t SEC   stop after SEC seconds even if not all requests were sent\n"
+        "  -i       send image bytes inline instead of through shared memory\n",
+        program);
+}
+
+int main(int argc, char* argv[]) {
+    LoadTest test;
+    Client* clients;
+    double* all;
+    size_t numClients = 4;
+    size_t total = 0, failed = 0, results = 0;
+    size_t i, j;
+    double seconds = 0;
+    double start;
+    int opt;
+    int status = 0;
+
+    memset(&test, 0, sizeof(test));
+    test.requestsPerClient = 100;
+
+    while ((opt = getopt(argc, argv, "s:c:n:t:ih")) != -1) {
+        switch (opt) {
+            case 's': test.socketPath = optarg; break;
+            case 'c': numClients = strtoul(optarg, NULL, 10); break;
+            case 'n': test.requestsPerClient = strtoul(optarg, NULL, 10); break;
+            case 't': seconds = strtod(optarg, NULL); break;
+            case 'i': test.useInline = 1; break;
+            default:
+                printUsage(argv[0]);
+                return 2;
+        }
+    }
+    if (optind != argc - 1 || numClients == 0 || test.requestsPerClient == 0) {
+        printUsage(argv[0]);
+        return 2;
+    }
+
+    test.image = loadFile(argv[optind], &test.imageSize);
+    if (test.image == NULL) {
+        fprintf(stderr, "Cannot read %s\n", argv[optind]);
+        return 2;
+    }
+
+    clients = (Client*) calloc(numClients, sizeof(Client));
+    all = (double*) malloc(numClients * test.requestsPerClient * sizeof(double));
+    if (clients == NULL || all == NULL) return 2;
+
+    start = nowMs();
+    test.deadline = seconds > 0 ? start + seconds * 1000.0 : 0;
+    for (i = 0; i < numClients; ++i) {
+        clients[i].test = &test;
+        clients[i].latencies = all + i * test.requestsPerClient;
+        pthread_create(&clients[i].thread, NULL, clientMain, &clients[i]);
+    }
+    for (i = 0; i < numClients; ++i) {
+        pthread_join(clients[i].thread, NULL);
+    }
+    seconds = (nowMs() - start) / 1000.0;
+
+    for (i = 0; i < numClients; ++i) {
+        if (clients[i].error != 0) {
+            fprintf(stderr, "Client %lu failed: %s\n", (unsigned long) i, strerror(-clients[i].error));
+            status = 1;
+        }
+        for (j = 0; j < clients[i].numRequests; ++j) {
+            all[total++] = clients[i].latencies[j];
+        }
+        failed += clients[i].numFailed;
+        results += clients[i].numResults;
+    }
+
+    printf("requests:   %lu (%lu with recognition error), %lu results\n",
+        (unsigned long) total, (unsigned long) failed, (unsigned long) results);
+    printf("throughput: %.1f requests/s with %lu clients over %.3f s\n",
+        seconds > 0 ? total / seconds : 0.0, (unsigned long) numClients, seconds);
+    if (total > 0) {
+        qsort(all, total, sizeof(double), compareDoubles);
+        printf("latency:    p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms\n",
+            all[total / 2], all[total * 90 / 100], all[total * 99 / 100], all[total - 1]);
+    }
+
+    free(all);
+    free(clients);
+    free((void*) test.image);
+    return status;
+}
@@ -0,0 +1,520 @@
+/*
+ * recognizerd.c
+ *
+ * Recognition daemon. Holds a pool of recognizers, created once at startup, and serves
+ * recognition requests from local processes over a Unix domain socket, so that processes
+ * on the same host do not each need their own recognizer and license initialization.
+ *
+ * Image bytes are received as a memfd and mapped read-only, so frames are never copied
+ * between processes. Clients that cannot pass file descriptors may send image bytes inline.
+ * Results are returned serialized with recognizerResultListSerialize. See RecognizerDaemonProtocol.h
+ * for the wire format and RecognizerClient.h for the client.
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+#include "RecognizerApi.h"
+#include "RecognizerDaemonProtocol.h"
+#include "RecognizerResultSerialization.h"
+
+#define DEFAULT_MAX_IMAGE_SIZE (64u << 20)
+#define DEFAULT_MAX_CONNECTIONS 256
+
+static volatile sig_atomic_t stopRequested_ = 0;
+
+static void onStopSignal(int signo) {
+    (void) signo;
+    stopRequested_ = 1;
+}
+
+/*==============================================================*/
+/*==================== RECOGNIZER POOL =========================*/
+/*==============================================================*/
+
+typedef struct RecognizerPool {
+    Recognizer** idle;
+    size_t numIdle;
+    pthread_mutex_t lock;
+    pthread_cond_t available;
+} RecognizerPool;
+
+static Recognizer* poolAcquire(RecognizerPool* pool) {
+    Recognizer* recognizer;
+    pthread_mutex_lock(&pool->lock);
+    while (pool->numIdle == 0) {
+        pthread_cond_wait(&pool->available, &pool->lock);
+    }
+    recognizer = pool->idle[--pool->numIdle];
+    pthread_mutex_unlock(&pool->lock);
+    return recognizer;
+}
+
+static void poolRelease(RecognizerPool* pool, Recognizer* recognizer) {
+    pthread_mutex_lock(&pool->lock);
+    pool->idle[pool->numIdle++] = recognizer;
+    pthread_cond_signal(&pool->available);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+static Recognizer* createRecognizer(const char* licensee, const char* licenseKey, unsigned int threadsPerRecognizer) {
+    RecognizerSettings* settings;
+    RecognizerDeviceInfo* deviceInfo;
+    Recognizer* recognizer = NULL;
+    RecognizerErrorStatus status;
+
+    recognizerSettingsCreate(&settings);
+    recognizerDeviceInfoCreate(&deviceInfo);
+    recognizerDeviceInfoSetNumberOfProcessors(deviceInfo, threadsPerRecognizer);
+    recognizerSettingsSetDeviceInfo(settings, deviceInfo);
+
+    {
+        Pdf417Settings pdf417Sett;
+        memset(&pdf417Sett, 0, sizeof(pdf417Sett));
+        pdf417Sett.useAutoScale = 1;
+        pdf417Sett.shouldScanUncertain = 1;
+        recognizerSettingsSetPdf417Settings(settings, &pdf417Sett);
+    }
+    {
+        ZXingSettings zxingSett;
+        memset(&zxingSett, 0, sizeof(zxingSett));
+        zxingSett.scanQRCode = 1;
+        recognizerSettingsSetZXingSettings(settings, &zxingSett);
+    }
+    {
+        UsdlSettings usdlSett;
+        memset(&usdlSett, 0, sizeof(usdlSett));
+        usdlSett.useAutoScale = 1;
+        recognizerSettingsSetUsdlSettings(settings, &usdlSett);
+    }
+
+    recognizerSettingsSetLicenseKey(settings, licensee, licenseKey);
+
+    status = recognizerCreate(&recognizer, settings);
+    if (status != RECOGNIZER_ERROR_STATUS_SUCCESS) {
+        fprintf(stderr, "Error creating recognizer: %s\n", recognizerErrorToString(status));
+        recognizer = NULL;
+    }
+
+    recognizerDeviceInfoDelete(&deviceInfo);
+    recognizerSettingsDelete(&settings);
+    return recognizer;
+}
+
+/*==============================================================*/
+/*======================= CONNECTIONS ==========================*/
+/*==============================================================*/
+
+typedef struct Daemon {
+    RecognizerPool pool;
+    uint64_t maxImageSize;
+    size_t maxConnections;
+    size_t numConnections;
+    pthread_mutex_t lock;
+} Daemon;
+
+typedef struct Connection {
+    Daemon* daemon;
+    int fd;
+    /* response buffer, reused between requests */
+    unsigned char* out;
+    size_t outSize;
+    size_t outCapacity;
+} Connection;
+
+static int readFull(int fd, void* buffer, size_t size) {
+    char* p = (char*) buffer;
+    while (size > 0) {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        size -= (size_t) n;
+    }
+    return 1;
+}
+
+static int writeFull(int fd, const void* buffer, size_t size) {
+    const char* p = (const char*) buffer;
+    while (size > 0) {
+        ssize_t n = send(fd, p, size, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return 0;
+        p += n;
+        size -= (size_t) n;
+    }
+    return 1;
+}
+
+/*
+ * Receives request header together with optional memfd. Returns 0 when connection was
+ * closed or request is malformed.
+ */
+static int receiveRequest(int fd, RecognizerdRequest* request, int* imageFd) {
+    union {
+        struct cmsghdr align;
+        char buffer[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct msghdr msg;
+    struct iovec iov;
+    struct cmsghdr* cmsg;
+    ssize_t n;
+
+    *imageFd = -1;
+    memset(&msg, 0, sizeof(msg));
+    iov.iov_base = request;
+    iov.iov_len = sizeof(*request);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buffer;
+    msg.msg_controllen = sizeof(control.buffer);
+
+    do {
+        n = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0) return 0;
+
+    for (cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS && cmsg->cmsg_len == CMSG_LEN(sizeof(int))) {
+            memcpy(imageFd, CMSG_DATA(cmsg), sizeof(int));
+        }
+    }
+    if (msg.msg_flags & MSG_CTRUNC) {
+        /* more descriptors than expected, the rest were discarded by the kernel */
+        if (*imageFd >= 0) close(*imageFd);
+        *imageFd = -1;
+        return 0;
+    }
+
+    if ((size_t) n < sizeof(*request) && !readFull(fd, (char*) request + n, sizeof(*request) - (size_t) n)) {
+        if (*imageFd >= 0) close(*imageFd);
+        *imageFd = -1;
+        return 0;
+    }
+    return 1;
+}
+
+static int outReserve(Connection* c, size_t extra) {
+    if (c->outSize + extra > c->outCapacity) {
+        size_t newCapacity = c->outCapacity ? c->outCapacity : 4096;
+        unsigned char* out;
+        while (c->outSize + extra > newCapacity) newCapacity *= 2;
+        out = (unsigned char*) realloc(c->out, newCapacity);
+        if (out == NULL) return 0;
+        c->out = out;
+        c->outCapacity = newCapacity;
+    }
+    return 1;
+}
+
+static int outAppend(Connection* c, const void* data, size_t size) {
+    if (!outReserve(c, size)) return 0;
+    memcpy(c->out + c->outSize, data, size);
+    c->outSize += size;
+    return 1;
+}
+
+/* serializes result list after response header that is already in output buffer */
+static int encodeResults(Connection* c, const RecognizerResultList* resultList) {
+    size_t needed = 0;
+    size_t headerSize = c->outSize;
+    if (recognizerResultListSerialize(resultList, c->out + headerSize, c->outCapacity - headerSize, &needed) == RECOGNIZER_ERROR_STATUS_SUCCESS) {
+        c->outSize += needed;
+        return 1;
+    }
+    if (!outReserve(c, needed)) return 0;
+    if (recognizerResultListSerialize(resultList, c->out + headerSize, c->outCapacity - headerSize, &needed) != RECOGNIZER_ERROR_STATUS_SUCCESS) return 0;
+    c->outSize += needed;
+    return 1;
+}
+
+/*
+ * Bytes occupied by raw image, or 0 if parameters are invalid or the image does not fit into
+ * request->size. Rows are checked against the available size before multiplying, so huge
+ * bytesPerRow values cannot wrap the product around.
+ */
+static uint64_t rawImageSize(const RecognizerdRequest* request) {
+    uint64_t bytesPerPixel;
+    uint64_t rows;
+    if (request->width <= 0 || request->height <= 0) return 0;
+    switch (request->rawType) {
+        case RAW_IMAGE_TYPE_BGRA: bytesPerPixel = 4; break;
+        case RAW_IMAGE_TYPE_BGR: bytesPerPixel = 3; break;
+        case RAW_IMAGE_TYPE_GRAY:
+        case RAW_IMAGE_TYPE_NV21: bytesPerPixel = 1; break;
+        default: return 0;
+    }
+    if (request->bytesPerRow < (uint64_t) request->width * bytesPerPixel) return 0;
+    rows = (uint64_t) request->height;
+    if (request->rawType == RAW_IMAGE_TYPE_NV21) {
+        /* full resolution Y plane followed by interleaved V/U plane with half as many rows, rounded up */
+        rows += (rows + 1) / 2;
+    }
+    if (request->bytesPerRow > request->size / rows) return 0;
+    return request->bytesPerRow * rows;
+}
+
+/* handles one request, returns 0 if connection should be closed */
+static int handleRequest(Connection* c, const RecognizerdRequest* request, int imageFd) {
+    Daemon* daemon = c->daemon;
+    const void* image = NULL;
+    void* mapping = MAP_FAILED;
+    void* inlineImage = NULL;
+    RecognizerResultList* resultList = NULL;
+    RecognizerdResponse response;
+    RecognizerErrorStatus status;
+    Recognizer* recognizer;
+    int ok = 1;
+
+    if (request->magic != RECOGNIZERD_MAGIC || request->version != RECOGNIZERD_PROTOCOL_VERSION) return 0;
+    /* sizes are later passed as size_t, which is 32-bit on x86 */
+    if (request->size == 0 || request->size > daemon->maxImageSize || request->size > (uint64_t) (size_t) -1) return 0;
+    if (request->imageKind == RECOGNIZERD_IMAGE_RAW) {
+        /* also guarantees bytesPerRow <= size */
+        if (rawImageSize(request) == 0) return 0;
+    } else if (request->imageKind != RECOGNIZERD_IMAGE_ENCODED) {
+        return 0;
+    }
+
+    if (request->flags & RECOGNIZERD_REQUEST_INLINE) {
+        if (imageFd >= 0) return 0;
+        inlineImage = malloc((size_t) request->size);
+        if (inlineImage == NULL || !readFull(c->fd, inlineImage, (size_t) request->size)) {
+            free(inlineImage);
+            return 0;
+        }
+        image = inlineImage;
+    } else {
+        struct stat st;
+        int seals;
+        if (imageFd < 0) return 0;
+        /* without F_SEAL_SHRINK client could truncate the file and crash the daemon with SIGBUS */
+        seals = fcntl(imageFd, F_GET_SEALS);
+        if (seals < 0 || !(seals & F_SEAL_SHRINK) || fstat(imageFd, &st) != 0 || (uint64_t) st.st_size < request->size) return 0;
+        mapping = mmap(NULL, (size_t) request->size, PROT_READ, MAP_SHARED, imageFd, 0);
+        if (mapping == MAP_FAILED) return 0;
+        image = mapping;
+    }
+
+    recognizer = poolAcquire(&daemon->pool);
+    if (request->imageKind == RECOGNIZERD_IMAGE_RAW) {
+        status = recognizerRecognizeFromRawImage(recognizer, &resultList, image, request->width, request->height,
+            (size_t) request->bytesPerRow, (RawImageType) request->rawType, 0, NULL);
+    } else {
+        status = recognizerRecognizeFromEncodedImage(recognizer, &resultList, image, (size_t) request->size, NULL);
+    }
+    poolRelease(&daemon->pool, recognizer);
+
+    if (mapping != MAP_FAILED) munmap(mapping, (size_t) request->size);
+    free(inlineImage);
+
+    c->outSize = 0;
+    memset(&response, 0, sizeof(response));
+    response.magic = RECOGNIZERD_MAGIC;
+    response.version = RECOGNIZERD_PROTOCOL_VERSION;
+    response.status = (int32_t) status;
+    ok = outAppend(c, &response, sizeof(response));
+    if (ok && status == RECOGNIZER_ERROR_STATUS_SUCCESS) {
+        ok = encodeResults(c, resultList);
+    }
+    recognizerResultListDelete(&resultList);
+
+    if (ok) {
+        response.length = (uint32_t) (c->outSize - sizeof(response));
+        memcpy(c->out, &response, sizeof(response));
+        ok = writeFull(c->fd, c->out, c->outSize);
+    }
+    return ok;
+}
+
+static void* connectionMain(void* arg) {
+    Connection* c = (Connection*) arg;
+    Daemon* daemon = c->daemon;
+    RecognizerdRequest request;
+    int imageFd;
+
+    while (!stopRequested_ && receiveRequest(c->fd, &request, &imageFd)) {
+        int keep = handleRequest(c, &request, imageFd);
+        if (imageFd >= 0) close(imageFd);
+        if (!keep) break;
+    }
+
+    close(c->fd);
+    free(c->out);
+    free(c);
+
+    pthread_mutex_lock(&daemon->lock);
+    daemon->numConnections--;
+    pthread_mutex_unlock(&daemon->lock);
+    return NULL;
+}
+
+/*==============================================================*/
+/*========================== MAIN ==============================*/
+/*==============================================================*/
+
+static int listenOn(const char* path) {
+    struct sockaddr_un addr;
+    int fd;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Socket path too long: %s\n", path);
+        return -1;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return -1;
+
+    /* remove stale socket left by crashed daemon, but never take over a running one */
+    if (connect(fd, (struct sockaddr*) &addr, sizeof(addr)) == 0) {
+        fprintf(stderr, "Another daemon is already listening on %s\n", path);
+        close(fd);
+        return -1;
+    }
+    unlink(path);
+
+    if (bind(fd, (struct sockaddr*) &addr, sizeof(addr)) != 0 || listen(fd, 128) != 0) {
+        fprintf(stderr, "Cannot listen on %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void printUsage(const char* program) {
+    fprintf(stderr,
+        "usage: %s [options]\n"
+        "  -s PATH      socket path (default " RECOGNIZERD_DEFAULT_SOCKET ")\n"
+        "  -n N         number of recognizers in pool (default: number of CPUs)\n"
+        "  -p N         processors given to each recognizer (default 1)\n"
+        "  -m BYTES     maximum accepted image size (default %u)\n"
+        "  -c N         maximum number of client connections (default %u)\n"
+        "  -L LICENSEE  licensee (default: $RECOGNIZER_LICENSEE)\n"
+        "  -K KEY       license key (default: $RECOGNIZER_LICENSE_KEY)\n",
+        program, DEFAULT_MAX_IMAGE_SIZE, DEFAULT_MAX_CONNECTIONS);
+}
+
+int main(int argc, char* argv[]) {
+    Daemon daemon;
+    const char* socketPath = RECOGNIZERD_DEFAULT_SOCKET;
+    const char* licensee = getenv("RECOGNIZER_LICENSEE");
+    const char* licenseKey = getenv("RECOGNIZER_LICENSE_KEY");
+    long numRecognizers = sysconf(_SC_NPROCESSORS_ONLN);
+    long threadsPerRecognizer = 1;
+    size_t poolSize;
+    size_t i;
+    int listenFd;
+    int opt;
+    struct sigaction sa;
+    pthread_attr_t attr;
+
+    memset(&daemon, 0, sizeof(daemon));
+    daemon.maxImageSize = DEFAULT_MAX_IMAGE_SIZE;
+    daemon.maxConnections = DEFAULT_MAX_CONNECTIONS;
+
+    while ((opt = getopt(argc, argv, "s:n:p:m:c:L:K:h")) != -1) {
+        switch (opt) {
+            case 's': socketPath = optarg; break;
+            case 'n': numRecognizers = strtol(optarg, NULL, 10); break;
+            case 'p': threadsPerRecognizer = strtol(optarg, NULL, 10); break;
+            case 'm': daemon.maxImageSize = strtoull(optarg, NULL, 10); break;
+            case 'c': daemon.maxConnections = strtoul(optarg, NULL, 10); break;
+            case 'L': licensee = optarg; break;
+            case 'K': licenseKey = optarg; break;
+            default:
+                printUsage(argv[0]);
+                return 2;
+        }
+    }
+    if (numRecognizers < 1) numRecognizers = 1;
+    if (threadsPerRecognizer < 1) threadsPerRecognizer = 1;
+    if (licensee == NULL || licenseKey == NULL) {
+        fprintf(stderr, "License is not set, use -L and -K or RECOGNIZER_LICENSEE and RECOGNIZER_LICENSE_KEY\n");
+        return 2;
+    }
+
+    poolSize = (size_t) numRecognizers;
+    daemon.pool.idle = (Recognizer**) calloc(poolSize, sizeof(Recognizer*));
+    if (daemon.pool.idle == NULL) return 2;
+    for (i = 0; i < poolSize; ++i) {
+        Recognizer* recognizer = createRecognizer(licensee, licenseKey, (unsigned int) threadsPerRecognizer);
+        if (recognizer == NULL) return 2;
+        daemon.pool.idle[daemon.pool.numIdle++] = recognizer;
+    }
+    pthread_mutex_init(&daemon.pool.lock, NULL);
+    pthread_cond_init(&daemon.pool.available, NULL);
+    pthread_mutex_init(&daemon.lock, NULL);
+
+    listenFd = listenOn(socketPath);
+    if (listenFd < 0) return 2;
+
+    /* no SA_RESTART, so that accept is interrupted */
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onStopSignal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+
+    fprintf(stderr, "Listening on %s with %lu recognizers\n", socketPath, (unsigned long) poolSize);
+
+    while (!stopRequested_) {
+        Connection* c;
+        pthread_t thread;
+        int accepted;
+        int fd = accept4(listenFd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EINTR) fprintf(stderr, "accept failed: %s\n", strerror(errno));
+            continue;
+        }
+
+        pthread_mutex_lock(&daemon.lock);
+        accepted = daemon.numConnections < daemon.maxConnections;
+        if (accepted) daemon.numConnections++;
+        pthread_mutex_unlock(&daemon.lock);
+
+        c = accepted ? (Connection*) calloc(1, sizeof(Connection)) : NULL;
+        if (c == NULL) {
+            close(fd);
+            if (accepted) {
+                pthread_mutex_lock(&daemon.lock);
+                daemon.numConnections--;
+                pthread_mutex_unlock(&daemon.lock);
+            }
+            continue;
+        }
+        c->daemon = &daemon;
+        c->fd = fd;
+        if (pthread_create(&thread, &attr, connectionMain, c) != 0) {
+            close(fd);
+            free(c);
+            pthread_mutex_lock(&daemon.lock);
+            daemon.numConnections--;
+            pthread_mutex_unlock(&daemon.lock);
+        }
+    }
+
+    close(listenFd);
+    unlink(socketPath);
+    fprintf(stderr, "Stopped\n");
+    /* connection threads may still hold recognizers, so the pool is left to process exit */
+    return 0;
+}